@@ -12,6 +12,9 @@
 #define HFI_CMD_Q_MINI_DUMP_SIZE_IN_BYTES      4096
 #define HFI_MSG_Q_MINI_DUMP_SIZE_IN_BYTES      4096
 
+#define HFI_Q_STATS_OCC_BUCKETS                8
+#define HFI_Q_STATS_WAIT_BUCKETS               12
+
 /**
  * struct hfi_mem
  * @len: length of memory
@@ -78,6 +81,19 @@ struct hfi_mini_dump_info {
 	bool           msg_q_state;
 	bool           cmd_q_state;
 };
+
+/**
+ * struct hfi_q_stats
+ * @occupancy: queue fill level seen on each write (cmd q) or read (msg q),
+ *             bucket n counts fill levels in [n, n + 1) / 8 of the queue
+ * @wait_us: time waited for the queue mutex, bucket 0 counts waits under
+ *           1us and bucket n waits in [2^(n - 1), 2^n) us, the last
+ *           bucket also counts anything longer
+ */
+struct hfi_q_stats {
+	uint64_t       occupancy[HFI_Q_STATS_OCC_BUCKETS];
+	uint64_t       wait_us[HFI_Q_STATS_WAIT_BUCKETS];
+};
 /**
  * hfi_write_cmd() - function for hfi write
  * @cmd_ptr: pointer to command data for hfi write
@@ -193,4 +209,13 @@ void cam_hfi_queue_dump(bool dump_queue_data);
  */
 void cam_hfi_mini_dump(struct hfi_mini_dump_info *dst);
 
+/**
+ * cam_hfi_get_q_stats() - copy the cmd and msg queue histograms, they
+ *                         are reset on every cam_hfi_init()
+ * @cmd_q: filled with the cmd queue histograms
+ * @msg_q: filled with the msg queue histograms
+ */
+void cam_hfi_get_q_stats(struct hfi_q_stats *cmd_q,
+	struct hfi_q_stats *msg_q);
+
 #endif /* _HFI_INTF_H_ */
@@ -12,6 +12,8 @@
 #include <linux/timer.h>
 #include <media/cam_icp.h>
 #include <linux/iopoll.h>
+#include <linux/ktime.h>
+#include <linux/log2.h>
 
 #include "cam_presil_hw_access.h"
 #include "cam_io_util.h"
@@ -45,6 +47,10 @@ unsigned int g_icp_mmu_hdl;
 static DEFINE_MUTEX(hfi_cmd_q_mutex);
 static DEFINE_MUTEX(hfi_msg_q_mutex);
 
+/* Protected by hfi_cmd_q_mutex and hfi_msg_q_mutex respectively */
+static struct hfi_q_stats hfi_cmd_q_stats;
+static struct hfi_q_stats hfi_msg_q_stats;
+
 static int cam_hfi_presil_setup(struct hfi_mem_info *hfi_mem);
 static int cam_hfi_presil_set_init_request(void);
 
@@ -172,13 +178,50 @@ void cam_hfi_queue_dump(bool dump_queue_data)
 		hfi_queue_dump(dwords, num_dwords);
 }
 
+void cam_hfi_get_q_stats(struct hfi_q_stats *cmd_q,
+	struct hfi_q_stats *msg_q)
+{
+	mutex_lock(&hfi_cmd_q_mutex);
+	memcpy(cmd_q, &hfi_cmd_q_stats, sizeof(*cmd_q));
+	mutex_unlock(&hfi_cmd_q_mutex);
+
+	mutex_lock(&hfi_msg_q_mutex);
+	memcpy(msg_q, &hfi_msg_q_stats, sizeof(*msg_q));
+	mutex_unlock(&hfi_msg_q_mutex);
+}
+
 #ifndef CONFIG_CAM_PRESIL
+static void hfi_q_stats_wait(struct hfi_q_stats *stats, ktime_t start)
+{
+	s64 wait_us = ktime_us_delta(ktime_get(), start);
+	int bkt = 0;
+
+	if (wait_us > 0)
+		bkt = min_t(int, ilog2(wait_us) + 1,
+			HFI_Q_STATS_WAIT_BUCKETS - 1);
+
+	stats->wait_us[bkt]++;
+}
+
+static void hfi_q_stats_occupancy(struct hfi_q_stats *stats,
+	uint32_t used, uint32_t q_size)
+{
+	if (!q_size || used > q_size)
+		return;
+
+	stats->occupancy[min_t(uint64_t,
+		(uint64_t)used * HFI_Q_STATS_OCC_BUCKETS / q_size,
+		HFI_Q_STATS_OCC_BUCKETS - 1)]++;
+}
+
 int hfi_write_cmd(void *cmd_ptr)
 {
 	uint32_t size_in_words, empty_space, new_write_idx, read_idx, temp;
+	uint32_t write_idx, q_size;
 	uint32_t *write_q, *write_ptr;
 	struct hfi_qtbl *q_tbl;
 	struct hfi_q_hdr *q;
+	ktime_t start;
 	int rc = 0;
 
 	if (!cmd_ptr) {
@@ -186,7 +229,9 @@ int hfi_write_cmd(void *cmd_ptr)
 		return -EINVAL;
 	}
 
+	start = ktime_get();
 	mutex_lock(&hfi_cmd_q_mutex);
+	hfi_q_stats_wait(&hfi_cmd_q_stats, start);
 	if (!g_hfi) {
 		CAM_ERR(CAM_HFI, "HFI interface not setup");
 		rc = -ENODEV;
@@ -213,10 +258,17 @@ int hfi_write_cmd(void *cmd_ptr)
 		goto err;
 	}
 
-	read_idx = q->qhdr_read_idx;
-	empty_space = (q->qhdr_write_idx >= read_idx) ?
-		(q->qhdr_q_size - (q->qhdr_write_idx - read_idx)) :
-		(read_idx - q->qhdr_write_idx);
+	/*
+	 * The queue header lives in memory shared with firmware, read each
+	 * field once and work on the local copies.
+	 */
+	read_idx = READ_ONCE(q->qhdr_read_idx);
+	write_idx = READ_ONCE(q->qhdr_write_idx);
+	q_size = READ_ONCE(q->qhdr_q_size);
+	empty_space = (write_idx >= read_idx) ?
+		(q_size - (write_idx - read_idx)) :
+		(read_idx - write_idx);
+	hfi_q_stats_occupancy(&hfi_cmd_q_stats, q_size - empty_space, q_size);
 	if (empty_space <= size_in_words) {
 		CAM_ERR(CAM_HFI, "failed: empty space %u, size_in_words %u",
 			empty_space, size_in_words);
@@ -224,14 +276,14 @@ int hfi_write_cmd(void *cmd_ptr)
 		goto err;
 	}
 
-	new_write_idx = q->qhdr_write_idx + size_in_words;
-	write_ptr = (uint32_t *)(write_q + q->qhdr_write_idx);
+	new_write_idx = write_idx + size_in_words;
+	write_ptr = (uint32_t *)(write_q + write_idx);
 
-	if (new_write_idx < q->qhdr_q_size) {
+	if (new_write_idx < q_size) {
 		memcpy(write_ptr, (uint8_t *)cmd_ptr,
 			size_in_words << BYTE_WORD_SHIFT);
 	} else {
-		new_write_idx -= q->qhdr_q_size;
+		new_write_idx -= q_size;
 		temp = (size_in_words - new_write_idx) << BYTE_WORD_SHIFT;
 		memcpy(write_ptr, (uint8_t *)cmd_ptr, temp);
 		memcpy(write_q, (uint8_t *)cmd_ptr + temp,
@@ -266,8 +318,10 @@ int hfi_read_message(uint32_t *pmsg, uint8_t q_id,
 	struct hfi_qtbl *q_tbl_ptr;
 	struct hfi_q_hdr *q;
 	uint32_t new_read_idx, size_in_words, word_diff, temp;
+	uint32_t read_idx, write_idx, q_size;
 	uint32_t *read_q, *read_ptr, *write_ptr;
 	uint32_t size_upper_bound = 0;
+	ktime_t start;
 	int rc = 0;
 
 	if (!pmsg) {
@@ -280,7 +334,9 @@ int hfi_read_message(uint32_t *pmsg, uint8_t q_id,
 		return -EINVAL;
 	}
 
+	start = ktime_get();
 	mutex_lock(&hfi_msg_q_mutex);
+	hfi_q_stats_wait(&hfi_msg_q_stats, start);
 	if (!g_hfi) {
 		CAM_ERR(CAM_HFI, "hfi not set up yet");
 		rc = -ENODEV;
@@ -298,44 +354,55 @@ int hfi_read_message(uint32_t *pmsg, uint8_t q_id,
 	q_tbl_ptr = (struct hfi_qtbl *)g_hfi->map.qtbl.kva;
 	q = &q_tbl_ptr->q_hdr[q_id];
 
-	if (q->qhdr_read_idx == q->qhdr_write_idx) {
+	/*
+	 * Snapshot the shared queue header once so the size computed below
+	 * stays consistent if firmware advances the write index meanwhile.
+	 */
+	read_idx = READ_ONCE(q->qhdr_read_idx);
+	write_idx = READ_ONCE(q->qhdr_write_idx);
+	q_size = READ_ONCE(q->qhdr_q_size);
+
+	if (read_idx == write_idx) {
 		CAM_DBG(CAM_HFI, "Q not ready, state:%u, r idx:%u, w idx:%u",
-			g_hfi->hfi_state, q->qhdr_read_idx, q->qhdr_write_idx);
+			g_hfi->hfi_state, read_idx, write_idx);
 		rc = -EIO;
 		goto err;
 	}
 
-	size_upper_bound = q->qhdr_q_size;
+	size_upper_bound = q_size;
 	if (q_id == Q_MSG)
 		read_q = (uint32_t *)g_hfi->map.msg_q.kva;
 	else
 		read_q = (uint32_t *)g_hfi->map.dbg_q.kva;
 
-	read_ptr = (uint32_t *)(read_q + q->qhdr_read_idx);
-	write_ptr = (uint32_t *)(read_q + q->qhdr_write_idx);
+	read_ptr = (uint32_t *)(read_q + read_idx);
+	write_ptr = (uint32_t *)(read_q + write_idx);
 
 	if (write_ptr > read_ptr)
 		size_in_words = write_ptr - read_ptr;
 	else {
 		word_diff = read_ptr - write_ptr;
-		size_in_words =  q->qhdr_q_size -  word_diff;
+		size_in_words =  q_size -  word_diff;
 	}
 
+	if (q_id == Q_MSG)
+		hfi_q_stats_occupancy(&hfi_msg_q_stats, size_in_words, q_size);
+
 	if ((size_in_words == 0) ||
 		(size_in_words > size_upper_bound)) {
 		CAM_ERR(CAM_HFI, "invalid HFI message packet size - 0x%08x",
 			size_in_words << BYTE_WORD_SHIFT);
-		q->qhdr_read_idx = q->qhdr_write_idx;
+		q->qhdr_read_idx = write_idx;
 		rc = -EIO;
 		goto err;
 	}
 
-	new_read_idx = q->qhdr_read_idx + size_in_words;
+	new_read_idx = read_idx + size_in_words;
 
-	if (new_read_idx < q->qhdr_q_size) {
+	if (new_read_idx < q_size) {
 		memcpy(pmsg, read_ptr, size_in_words << BYTE_WORD_SHIFT);
 	} else {
-		new_read_idx -= q->qhdr_q_size;
+		new_read_idx -= q_size;
 		temp = (size_in_words - new_read_idx) << BYTE_WORD_SHIFT;
 		memcpy(pmsg, read_ptr, temp);
 		memcpy((uint8_t *)pmsg + temp, read_q,
@@ -765,6 +832,8 @@ int cam_hfi_init(struct hfi_mem_info *hfi_mem, const struct hfi_ops *hfi_ops,
 
 	mutex_lock(&hfi_cmd_q_mutex);
 	mutex_lock(&hfi_msg_q_mutex);
+	memset(&hfi_cmd_q_stats, 0, sizeof(hfi_cmd_q_stats));
+	memset(&hfi_msg_q_stats, 0, sizeof(hfi_msg_q_stats));
 
 	if (!g_hfi) {
 		g_hfi = kzalloc(sizeof(struct hfi_info), GFP_KERNEL);
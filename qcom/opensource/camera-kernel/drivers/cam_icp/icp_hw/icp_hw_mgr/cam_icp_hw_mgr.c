@@ -18,6 +18,7 @@
 #include <linux/delay.h>
 #include <linux/debugfs.h>
 #include <linux/rwsem.h>
+#include <linux/seq_file.h>
 #include <media/cam_defs.h>
 #include <media/cam_icp.h>
 #include <media/cam_cpas.h>
@@ -2016,6 +2017,32 @@ static int cam_icp_get_irq_line_test(void *data, u64 *val)
 DEFINE_SIMPLE_ATTRIBUTE(cam_icp_irq_line_test, cam_icp_get_irq_line_test,
 	cam_icp_set_irq_line_test, "%08llu");
 
+static void cam_icp_hfi_q_stats_print(struct seq_file *m,
+	const char *name, struct hfi_q_stats *stats)
+{
+	int i;
+
+	seq_printf(m, "%s occupancy:", name);
+	for (i = 0; i < HFI_Q_STATS_OCC_BUCKETS; i++)
+		seq_printf(m, " %llu", stats->occupancy[i]);
+	seq_printf(m, "\n%s wait_us:", name);
+	for (i = 0; i < HFI_Q_STATS_WAIT_BUCKETS; i++)
+		seq_printf(m, " %llu", stats->wait_us[i]);
+	seq_puts(m, "\n");
+}
+
+static int cam_icp_hfi_q_stats_show(struct seq_file *m, void *unused)
+{
+	struct hfi_q_stats cmd_q, msg_q;
+
+	cam_hfi_get_q_stats(&cmd_q, &msg_q);
+	cam_icp_hfi_q_stats_print(m, "cmd_q", &cmd_q);
+	cam_icp_hfi_q_stats_print(m, "msg_q", &msg_q);
+
+	return 0;
+}
+DEFINE_SHOW_ATTRIBUTE(cam_icp_hfi_q_stats);
+
 static int cam_icp_hw_mgr_create_debugfs_entry(void)
 {
 	int rc = 0;
@@ -2064,6 +2091,9 @@ static int cam_icp_hw_mgr_create_debugfs_entry(void)
 	debugfs_create_file("test_irq_line", 0644,
 		icp_hw_mgr.dentry, NULL, &cam_icp_irq_line_test);
 
+	debugfs_create_file("hfi_q_stats", 0444,
+		icp_hw_mgr.dentry, NULL, &cam_icp_hfi_q_stats_fops);
+
 end:
 	/* Set default hang dump lvl */
 	icp_hw_mgr.icp_fw_dump_lvl = HFI_FW_DUMP_ON_FAILURE;
@@ -24,6 +24,7 @@
 #include "cam_trace.h"
 #include "cam_common_util.h"
 #include "cam_presil_hw_access.h"
+#include "cam_packet_util.h"
 #include "cam_compat.h"
 
 #define CAM_MEM_SHARED_BUFFER_PAD_4K (4 * 1024)
@@ -36,13 +37,65 @@ static atomic_t cam_mem_mgr_state = ATOMIC_INIT(CAM_MEM_MGR_UNINITIALIZED);
  * @dentry                  : Directory entry to the mem mgr root folder
  * @alloc_profile_enable    : Whether to enable alloc profiling
  * @override_cpu_access_dir : Override cpu access direction to BIDIRECTIONAL
+ * @lock_profile_enable     : Whether to enable table lock profiling
+ * @m_lock_cnt              : Number of profiled table lock acquisitions
+ * @m_lock_wait_ns          : Total time spent waiting for the table lock
+ * @m_lock_wait_max_ns      : Longest wait for the table lock
+ * @m_lock_hold_ns          : Total time the table lock was held
+ * @m_lock_hold_max_ns      : Longest hold of the table lock
+ * @m_lock_ts               : Time the table lock was taken, 0 if not profiled
  */
 static struct {
 	struct dentry *dentry;
 	bool alloc_profile_enable;
 	bool override_cpu_access_dir;
+	bool lock_profile_enable;
+	u64 m_lock_cnt;
+	u64 m_lock_wait_ns;
+	u64 m_lock_wait_max_ns;
+	u64 m_lock_hold_ns;
+	u64 m_lock_hold_max_ns;
+	ktime_t m_lock_ts;
 } g_cam_mem_mgr_debug;
 
+static void cam_mem_mgr_tbl_lock(void)
+{
+	ktime_t start;
+	u64 wait_ns;
+
+	if (!g_cam_mem_mgr_debug.lock_profile_enable) {
+		mutex_lock(&tbl.m_lock);
+		return;
+	}
+
+	start = ktime_get();
+	mutex_lock(&tbl.m_lock);
+	g_cam_mem_mgr_debug.m_lock_ts = ktime_get();
+
+	wait_ns = ktime_to_ns(ktime_sub(g_cam_mem_mgr_debug.m_lock_ts, start));
+	g_cam_mem_mgr_debug.m_lock_cnt++;
+	g_cam_mem_mgr_debug.m_lock_wait_ns += wait_ns;
+	if (wait_ns > g_cam_mem_mgr_debug.m_lock_wait_max_ns)
+		g_cam_mem_mgr_debug.m_lock_wait_max_ns = wait_ns;
+}
+
+static void cam_mem_mgr_tbl_unlock(void)
+{
+	u64 hold_ns;
+
+	/* Profiling may have been turned on while the lock was held */
+	if (g_cam_mem_mgr_debug.m_lock_ts) {
+		hold_ns = ktime_to_ns(ktime_sub(ktime_get(),
+			g_cam_mem_mgr_debug.m_lock_ts));
+		g_cam_mem_mgr_debug.m_lock_hold_ns += hold_ns;
+		if (hold_ns > g_cam_mem_mgr_debug.m_lock_hold_max_ns)
+			g_cam_mem_mgr_debug.m_lock_hold_max_ns = hold_ns;
+		g_cam_mem_mgr_debug.m_lock_ts = 0;
+	}
+
+	mutex_unlock(&tbl.m_lock);
+}
+
 #if IS_REACHABLE(CONFIG_DMABUF_HEAPS)
 static void cam_mem_mgr_put_dma_heaps(void);
 static int cam_mem_mgr_get_dma_heaps(void);
@@ -198,6 +251,26 @@ static int cam_mem_mgr_create_debug_fs(void)
 
 	debugfs_create_bool("override_cpu_access_dir", 0644, g_cam_mem_mgr_debug.dentry,
 		&g_cam_mem_mgr_debug.override_cpu_access_dir);
+
+	debugfs_create_bool("lock_profile_enable", 0644, g_cam_mem_mgr_debug.dentry,
+		&g_cam_mem_mgr_debug.lock_profile_enable);
+
+	debugfs_create_u64("m_lock_cnt", 0644, g_cam_mem_mgr_debug.dentry,
+		&g_cam_mem_mgr_debug.m_lock_cnt);
+
+	debugfs_create_u64("m_lock_wait_ns", 0644, g_cam_mem_mgr_debug.dentry,
+		&g_cam_mem_mgr_debug.m_lock_wait_ns);
+
+	debugfs_create_u64("m_lock_wait_max_ns", 0644, g_cam_mem_mgr_debug.dentry,
+		&g_cam_mem_mgr_debug.m_lock_wait_max_ns);
+
+	debugfs_create_u64("m_lock_hold_ns", 0644, g_cam_mem_mgr_debug.dentry,
+		&g_cam_mem_mgr_debug.m_lock_hold_ns);
+
+	debugfs_create_u64("m_lock_hold_max_ns", 0644, g_cam_mem_mgr_debug.dentry,
+		&g_cam_mem_mgr_debug.m_lock_hold_max_ns);
+
+	cam_packet_util_create_debugfs(g_cam_mem_mgr_debug.dentry);
 end:
 	return rc;
 }
@@ -238,6 +311,7 @@ int cam_mem_mgr_init(void)
 	bitmap_zero(tbl.bitmap, tbl.bits);
 	/* We need to reserve slot 0 because 0 is invalid */
 	set_bit(0, tbl.bitmap);
+	tbl.next_idx = 1;
 
 	for (i = 1; i < CAM_MEM_BUFQ_MAX; i++) {
 		tbl.bufq[i].fd = -1;
@@ -264,26 +338,34 @@ static int32_t cam_mem_get_slot(void)
 {
 	int32_t idx;
 
-	mutex_lock(&tbl.m_lock);
-	idx = find_first_zero_bit(tbl.bitmap, tbl.bits);
+	cam_mem_mgr_tbl_lock();
+	/*
+	 * Search from just past the last slot handed out so the busy low
+	 * slots are not rescanned on every allocation, and a freed slot is
+	 * not reused right away under a stale handle.
+	 */
+	idx = find_next_zero_bit(tbl.bitmap, tbl.bits, tbl.next_idx);
+	if (idx >= CAM_MEM_BUFQ_MAX)
+		idx = find_next_zero_bit(tbl.bitmap, tbl.bits, 1);
 	if (idx >= CAM_MEM_BUFQ_MAX || idx <= 0) {
-		mutex_unlock(&tbl.m_lock);
+		cam_mem_mgr_tbl_unlock();
 		return -ENOMEM;
 	}
 
 	set_bit(idx, tbl.bitmap);
+	tbl.next_idx = idx + 1;
 	tbl.bufq[idx].active = true;
 	tbl.bufq[idx].release_deferred = false;
 	CAM_GET_TIMESTAMP((tbl.bufq[idx].timestamp));
 	mutex_init(&tbl.bufq[idx].q_lock);
-	mutex_unlock(&tbl.m_lock);
+	cam_mem_mgr_tbl_unlock();
 
 	return idx;
 }
 
 static void cam_mem_put_slot(int32_t idx)
 {
-	mutex_lock(&tbl.m_lock);
+	cam_mem_mgr_tbl_lock();
 	mutex_lock(&tbl.bufq[idx].q_lock);
 	tbl.bufq[idx].active = false;
 	tbl.bufq[idx].release_deferred = false;
@@ -292,7 +374,7 @@ static void cam_mem_put_slot(int32_t idx)
 	mutex_unlock(&tbl.bufq[idx].q_lock);
 	mutex_destroy(&tbl.bufq[idx].q_lock);
 	clear_bit(idx, tbl.bitmap);
-	mutex_unlock(&tbl.m_lock);
+	cam_mem_mgr_tbl_unlock();
 }
 
 int cam_mem_get_io_buf(int32_t buf_handle, int32_t mmu_handle,
@@ -414,17 +496,17 @@ int cam_mem_mgr_cache_ops(struct cam_mem_cache_ops_cmd *cmd)
 	if (idx >= CAM_MEM_BUFQ_MAX || idx <= 0)
 		return -EINVAL;
 
-	mutex_lock(&tbl.m_lock);
+	cam_mem_mgr_tbl_lock();
 
 	if (!test_bit(idx, tbl.bitmap)) {
 		CAM_ERR(CAM_MEM, "Buffer at idx=%d is already unmapped,",
 			idx);
-		mutex_unlock(&tbl.m_lock);
+		cam_mem_mgr_tbl_unlock();
 		return -EINVAL;
 	}
 
 	mutex_lock(&tbl.bufq[idx].q_lock);
-	mutex_unlock(&tbl.m_lock);
+	cam_mem_mgr_tbl_unlock();
 
 	if (cmd->buf_handle != tbl.bufq[idx].buf_handle) {
 		rc = -EINVAL;
@@ -506,16 +588,16 @@ int cam_mem_mgr_cpu_access_op(struct cam_mem_cpu_access_op *cmd)
 		return -EINVAL;
 	}
 
-	mutex_lock(&tbl.m_lock);
+	cam_mem_mgr_tbl_lock();
 
 	if (!test_bit(idx, tbl.bitmap)) {
 		CAM_ERR(CAM_MEM, "Buffer at idx=%d is already freed/unmapped", idx);
-		mutex_unlock(&tbl.m_lock);
+		cam_mem_mgr_tbl_unlock();
 		return -EINVAL;
 	}
 
 	mutex_lock(&tbl.bufq[idx].q_lock);
-	mutex_unlock(&tbl.m_lock);
+	cam_mem_mgr_tbl_unlock();
 
 	if (cmd->buf_handle != tbl.bufq[idx].buf_handle) {
 		CAM_ERR(CAM_MEM,
@@ -1223,14 +1305,14 @@ static bool cam_mem_util_is_map_internal(int32_t fd, unsigned i_ino)
 	uint32_t i;
 	bool is_internal = false;
 
-	mutex_lock(&tbl.m_lock);
+	cam_mem_mgr_tbl_lock();
 	for_each_set_bit(i, tbl.bitmap, tbl.bits) {
 		if ((tbl.bufq[i].fd == fd) && (tbl.bufq[i].i_ino == i_ino)) {
 			is_internal = tbl.bufq[i].is_internal;
 			break;
 		}
 	}
-	mutex_unlock(&tbl.m_lock);
+	cam_mem_mgr_tbl_unlock();
 
 	return is_internal;
 }
@@ -1447,7 +1529,7 @@ static int cam_mem_mgr_cleanup_table(void)
 {
 	int i;
 
-	mutex_lock(&tbl.m_lock);
+	cam_mem_mgr_tbl_lock();
 	for (i = 1; i < CAM_MEM_BUFQ_MAX; i++) {
 		if (!tbl.bufq[i].active) {
 			CAM_DBG(CAM_MEM,
@@ -1486,7 +1568,8 @@ static int cam_mem_mgr_cleanup_table(void)
 	bitmap_zero(tbl.bitmap, tbl.bits);
 	/* We need to reserve slot 0 because 0 is invalid */
 	set_bit(0, tbl.bitmap);
-	mutex_unlock(&tbl.m_lock);
+	tbl.next_idx = 1;
+	cam_mem_mgr_tbl_unlock();
 
 	return 0;
 }
@@ -1498,12 +1581,12 @@ void cam_mem_mgr_deinit(void)
 
 	atomic_set(&cam_mem_mgr_state, CAM_MEM_MGR_UNINITIALIZED);
 	cam_mem_mgr_cleanup_table();
-	mutex_lock(&tbl.m_lock);
+	cam_mem_mgr_tbl_lock();
 	bitmap_zero(tbl.bitmap, tbl.bits);
 	kfree(tbl.bitmap);
 	tbl.bitmap = NULL;
 	tbl.dbg_buf_idx = -1;
-	mutex_unlock(&tbl.m_lock);
+	cam_mem_mgr_tbl_unlock();
 	mutex_destroy(&tbl.m_lock);
 }
 
@@ -1526,12 +1609,12 @@ static void cam_mem_util_unmap(struct kref *kref)
 
 	CAM_DBG(CAM_MEM, "Flags = %X idx %d", tbl.bufq[idx].flags, idx);
 
-	mutex_lock(&tbl.m_lock);
+	cam_mem_mgr_tbl_lock();
 	if ((!tbl.bufq[idx].active) &&
 		(tbl.bufq[idx].vaddr) == 0) {
 		CAM_WARN(CAM_MEM, "Buffer at idx=%d is already unmapped,",
 			idx);
-		mutex_unlock(&tbl.m_lock);
+		cam_mem_mgr_tbl_unlock();
 		return;
 	}
 
@@ -1541,7 +1624,7 @@ static void cam_mem_util_unmap(struct kref *kref)
 	tbl.bufq[idx].vaddr = 0;
 	tbl.bufq[idx].release_deferred = false;
 	mutex_unlock(&tbl.bufq[idx].q_lock);
-	mutex_unlock(&tbl.m_lock);
+	cam_mem_mgr_tbl_unlock();
 
 	if (tbl.bufq[idx].flags & CAM_MEM_FLAG_KMD_ACCESS) {
 		if (tbl.bufq[idx].dma_buf && tbl.bufq[idx].kmdvaddr) {
@@ -1571,7 +1654,7 @@ static void cam_mem_util_unmap(struct kref *kref)
 				tbl.bufq[idx].dma_buf);
 	}
 
-	mutex_lock(&tbl.m_lock);
+	cam_mem_mgr_tbl_lock();
 	mutex_lock(&tbl.bufq[idx].q_lock);
 	tbl.bufq[idx].flags = 0;
 	tbl.bufq[idx].buf_handle = -1;
@@ -1598,7 +1681,7 @@ static void cam_mem_util_unmap(struct kref *kref)
 	mutex_unlock(&tbl.bufq[idx].q_lock);
 	mutex_destroy(&tbl.bufq[idx].q_lock);
 	clear_bit(idx, tbl.bitmap);
-	mutex_unlock(&tbl.m_lock);
+	cam_mem_mgr_tbl_unlock();
 
 }
 
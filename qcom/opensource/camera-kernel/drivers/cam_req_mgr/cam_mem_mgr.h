@@ -93,6 +93,7 @@ struct cam_mem_buf_queue {
  * @m_lock: mutex lock for table
  * @bitmap: bitmap of the mem mgr utility
  * @bits: max bits of the utility
+ * @next_idx: slot index the next free slot search starts from
  * @bufq: array of buffers
  * @dbg_buf_idx: debug buffer index to get usecases info
  * @force_cache_allocs: Force all internal buffer allocations with cache
@@ -109,6 +110,7 @@ struct cam_mem_table {
 	struct mutex m_lock;
 	void *bitmap;
 	size_t bits;
+	size_t next_idx;
 	struct cam_mem_buf_queue bufq[CAM_MEM_BUFQ_MAX];
 	size_t dbg_buf_idx;
 	bool force_cache_allocs;
@@ -17,6 +17,7 @@
 #include <linux/genalloc.h>
 #include <linux/debugfs.h>
 #include <linux/dma-iommu.h>
+#include <linux/hashtable.h>
 
 #include <soc/qcom/secure_buffer.h>
 
@@ -24,6 +25,7 @@
 
 #include "cam_compat.h"
 #include "cam_smmu_api.h"
+#include "cam_mem_mgr_api.h"
 #include "cam_debug_util.h"
 #include "camera_main.h"
 #include "cam_trace.h"
@@ -40,6 +42,8 @@
 #define HANDLE_INIT (-1)
 #define CAM_SMMU_CB_MAX 6
 #define CAM_SMMU_SHARED_HDL_MAX 6
+#define CAM_SMMU_BUF_HASH_BITS 7
+#define CAM_SMMU_CHURN_TEST_BUFS 32
 
 #define GET_SMMU_HDL(x, y) (((x) << COOKIE_SIZE) | ((y) & COOKIE_MASK))
 #define GET_SMMU_TABLE_IDX(x) (((x) >> COOKIE_SIZE) & COOKIE_MASK)
@@ -123,6 +127,7 @@ struct cam_smmu_debug {
 	struct dentry *dentry;
 	bool cb_dump_enable;
 	bool map_profile_enable;
+	bool map_index_check;
 	uint32_t fatal_pf_mask;
 };
 
@@ -163,6 +168,10 @@ struct cam_context_bank_info {
 
 	struct list_head smmu_buf_list;
 	struct list_head smmu_buf_kernel_list;
+	/* index of smmu_buf_list by (fd, i_ino) */
+	DECLARE_HASHTABLE(smmu_buf_hash, CAM_SMMU_BUF_HASH_BITS);
+	/* index of smmu_buf_kernel_list by dma_buf */
+	DECLARE_HASHTABLE(smmu_buf_kernel_hash, CAM_SMMU_BUF_HASH_BITS);
 	struct mutex lock;
 	int handle;
 	enum cam_smmu_ops_param state;
@@ -217,6 +226,7 @@ struct cam_dma_buff_info {
 	int ref_count;
 	dma_addr_t paddr;
 	struct list_head list;
+	struct hlist_node hlist;
 	int ion_fd;
 	unsigned long i_ino;
 	size_t len;
@@ -985,6 +995,8 @@ void cam_smmu_reset_iommu_table(enum cam_smmu_init_dir ops)
 		iommu_cb_set.cb_info[i].handle = HANDLE_INIT;
 		INIT_LIST_HEAD(&iommu_cb_set.cb_info[i].smmu_buf_list);
 		INIT_LIST_HEAD(&iommu_cb_set.cb_info[i].smmu_buf_kernel_list);
+		hash_init(iommu_cb_set.cb_info[i].smmu_buf_hash);
+		hash_init(iommu_cb_set.cb_info[i].smmu_buf_kernel_hash);
 		iommu_cb_set.cb_info[i].state = CAM_SMMU_DETACH;
 		iommu_cb_set.cb_info[i].dev = NULL;
 		iommu_cb_set.cb_info[i].cb_count = 0;
@@ -1216,6 +1228,73 @@ static int cam_smmu_free_scratch_va(struct scratch_mapping *mapping,
 	return 0;
 }
 
+static inline unsigned long cam_smmu_buf_key(int ion_fd, unsigned long i_ino)
+{
+	return (unsigned long)ion_fd ^ i_ino;
+}
+
+/*
+ * Debug check that every mapping on the user and kernel buffer lists of a
+ * context bank is found through its hash index, and that the indexes hold
+ * nothing else. Scratch mappings are listed but not indexed. Must be called
+ * with the context bank lock held.
+ */
+static int cam_smmu_check_buf_index(int idx)
+{
+	struct cam_context_bank_info *cb = &iommu_cb_set.cb_info[idx];
+	struct cam_dma_buff_info *mapping, *found;
+	int bkt;
+	uint32_t list_cnt = 0, hash_cnt = 0;
+	uint32_t klist_cnt = 0, khash_cnt = 0;
+
+	if (cb->is_secure)
+		return 0;
+
+	list_for_each_entry(mapping, &cb->smmu_buf_list, list) {
+		if (mapping->region_id == CAM_SMMU_REGION_SCRATCH)
+			continue;
+		list_cnt++;
+		hash_for_each_possible(cb->smmu_buf_hash, found, hlist,
+			cam_smmu_buf_key(mapping->ion_fd, mapping->i_ino)) {
+			if (found == mapping)
+				break;
+		}
+		if (found != mapping) {
+			CAM_ERR(CAM_SMMU, "%s fd %d i_ino %lu not in hash",
+				cb->name[0], mapping->ion_fd, mapping->i_ino);
+			return -EINVAL;
+		}
+	}
+
+	list_for_each_entry(mapping, &cb->smmu_buf_kernel_list, list) {
+		klist_cnt++;
+		hash_for_each_possible(cb->smmu_buf_kernel_hash, found, hlist,
+			(unsigned long)mapping->buf) {
+			if (found == mapping)
+				break;
+		}
+		if (found != mapping) {
+			CAM_ERR(CAM_SMMU, "%s dma_buf %pK not in kernel hash",
+				cb->name[0], mapping->buf);
+			return -EINVAL;
+		}
+	}
+
+	hash_for_each(cb->smmu_buf_hash, bkt, mapping, hlist)
+		hash_cnt++;
+	hash_for_each(cb->smmu_buf_kernel_hash, bkt, mapping, hlist)
+		khash_cnt++;
+
+	if ((list_cnt != hash_cnt) || (klist_cnt != khash_cnt)) {
+		CAM_ERR(CAM_SMMU,
+			"%s index mismatch list %u hash %u kernel list %u hash %u",
+			cb->name[0], list_cnt, hash_cnt, klist_cnt, khash_cnt);
+		return -EINVAL;
+	}
+
+	return 0;
+}
+
 static struct cam_dma_buff_info *cam_smmu_find_mapping_by_virt_address(int idx,
 	dma_addr_t virt_addr)
 {
@@ -1248,9 +1327,8 @@ static struct cam_dma_buff_info *cam_smmu_find_mapping_by_ion_index(int idx,
 
 	i_ino = file_inode(dmabuf->file)->i_ino;
 
-	list_for_each_entry(mapping,
-			&iommu_cb_set.cb_info[idx].smmu_buf_list,
-			list) {
+	hash_for_each_possible(iommu_cb_set.cb_info[idx].smmu_buf_hash,
+			mapping, hlist, cam_smmu_buf_key(ion_fd, i_ino)) {
 		if ((mapping->ion_fd == ion_fd) && (mapping->i_ino == i_ino)) {
 			CAM_DBG(CAM_SMMU, "find ion_fd %d i_ino %lu", ion_fd, i_ino);
 			return mapping;
@@ -1273,9 +1351,8 @@ static struct cam_dma_buff_info *cam_smmu_find_mapping_by_dma_buf(int idx,
 		return NULL;
 	}
 
-	list_for_each_entry(mapping,
-			&iommu_cb_set.cb_info[idx].smmu_buf_kernel_list,
-			list) {
+	hash_for_each_possible(iommu_cb_set.cb_info[idx].smmu_buf_kernel_hash,
+			mapping, hlist, (unsigned long)buf) {
 		if (mapping->buf == buf) {
 			CAM_DBG(CAM_SMMU, "find dma_buf %pK", buf);
 			return mapping;
@@ -2349,6 +2426,10 @@ static int cam_smmu_map_buffer_and_add_to_list(int idx, int ion_fd,
 	/* add to the list */
 	list_add(&mapping_info->list,
 		&iommu_cb_set.cb_info[idx].smmu_buf_list);
+	hash_add(iommu_cb_set.cb_info[idx].smmu_buf_hash, &mapping_info->hlist,
+		cam_smmu_buf_key(ion_fd, mapping_info->i_ino));
+	if (iommu_cb_set.debug_cfg.map_index_check)
+		cam_smmu_check_buf_index(idx);
 
 	CAM_DBG(CAM_SMMU, "fd %d i_ino %lu dmabuf %pK", ion_fd, mapping_info->i_ino, buf);
 
@@ -2381,6 +2462,10 @@ static int cam_smmu_map_kernel_buffer_and_add_to_list(int idx,
 	/* add to the list */
 	list_add(&mapping_info->list,
 		&iommu_cb_set.cb_info[idx].smmu_buf_kernel_list);
+	hash_add(iommu_cb_set.cb_info[idx].smmu_buf_kernel_hash,
+		&mapping_info->hlist, (unsigned long)buf);
+	if (iommu_cb_set.debug_cfg.map_index_check)
+		cam_smmu_check_buf_index(idx);
 
 	CAM_DBG(CAM_SMMU, "fd %d i_ino %lu dmabuf %pK",
 		mapping_info->ion_fd, mapping_info->i_ino, buf);
@@ -2475,6 +2560,9 @@ static int cam_smmu_unmap_buf_and_remove_from_list(
 	mapping_info->buf = NULL;
 
 	list_del_init(&mapping_info->list);
+	hash_del(&mapping_info->hlist);
+	if (iommu_cb_set.debug_cfg.map_index_check)
+		cam_smmu_check_buf_index(idx);
 
 	/* free one buffer */
 	kfree(mapping_info);
@@ -2490,8 +2578,8 @@ static enum cam_smmu_buf_state cam_smmu_check_fd_in_list(int idx,
 
 	i_ino = file_inode(dmabuf->file)->i_ino;
 
-	list_for_each_entry(mapping,
-		&iommu_cb_set.cb_info[idx].smmu_buf_list, list) {
+	hash_for_each_possible(iommu_cb_set.cb_info[idx].smmu_buf_hash,
+		mapping, hlist, cam_smmu_buf_key(ion_fd, i_ino)) {
 		if ((mapping->ion_fd == ion_fd) && (mapping->i_ino == i_ino)) {
 			*paddr_ptr = mapping->paddr;
 			*len_ptr = mapping->len;
@@ -2512,8 +2600,8 @@ static enum cam_smmu_buf_state cam_smmu_user_reuse_fd_in_list(int idx,
 
 	i_ino = file_inode(dmabuf->file)->i_ino;
 
-	list_for_each_entry(mapping,
-		&iommu_cb_set.cb_info[idx].smmu_buf_list, list) {
+	hash_for_each_possible(iommu_cb_set.cb_info[idx].smmu_buf_hash,
+		mapping, hlist, cam_smmu_buf_key(ion_fd, i_ino)) {
 		if ((mapping->ion_fd == ion_fd) && (mapping->i_ino == i_ino)) {
 			*paddr_ptr = mapping->paddr;
 			*len_ptr = mapping->len;
@@ -2531,8 +2619,8 @@ static enum cam_smmu_buf_state cam_smmu_check_dma_buf_in_list(int idx,
 {
 	struct cam_dma_buff_info *mapping;
 
-	list_for_each_entry(mapping,
-		&iommu_cb_set.cb_info[idx].smmu_buf_kernel_list, list) {
+	hash_for_each_possible(iommu_cb_set.cb_info[idx].smmu_buf_kernel_hash,
+		mapping, hlist, (unsigned long)buf) {
 		if (mapping->buf == buf) {
 			*paddr_ptr = mapping->paddr;
 			*len_ptr = mapping->len;
@@ -4510,6 +4598,106 @@ static int cam_smmu_get_fatal_pf_mask(void *data, u64 *val)
 DEFINE_DEBUGFS_ATTRIBUTE(cam_smmu_fatal_pf_mask,
 	cam_smmu_get_fatal_pf_mask, cam_smmu_set_fatal_pf_mask, "%16llu");
 
+static int cam_smmu_map_churn_test_cb(int idx, u64 iterations)
+{
+	struct cam_context_bank_info *cb = &iommu_cb_set.cb_info[idx];
+	struct cam_mem_mgr_request_desc req;
+	struct cam_mem_mgr_memory_desc *bufs;
+	u64 iter;
+	int i, rc = 0, check_rc;
+
+	bufs = kcalloc(CAM_SMMU_CHURN_TEST_BUFS, sizeof(*bufs), GFP_KERNEL);
+	if (!bufs)
+		return -ENOMEM;
+
+	for (iter = 0; iter < iterations; iter++) {
+		for (i = 0; i < CAM_SMMU_CHURN_TEST_BUFS; i++) {
+			memset(&req, 0, sizeof(req));
+			req.size = PAGE_SIZE;
+			req.smmu_hdl = cb->handle;
+			req.flags = cb->shared_support ?
+				CAM_MEM_FLAG_HW_SHARED_ACCESS :
+				CAM_MEM_FLAG_HW_READ_WRITE;
+			rc = cam_mem_mgr_request_mem(&req, &bufs[i]);
+			if (rc) {
+				CAM_ERR(CAM_SMMU, "%s iter %llu buf %d map failed rc %d",
+					cb->name[0], iter, i, rc);
+				goto release;
+			}
+		}
+
+		mutex_lock(&cb->lock);
+		rc = cam_smmu_check_buf_index(idx);
+		mutex_unlock(&cb->lock);
+		if (rc)
+			goto release;
+
+		/* Unmap odd then even slots so removals hit every chain position */
+		for (i = 1; i < CAM_SMMU_CHURN_TEST_BUFS; i += 2) {
+			cam_mem_mgr_release_mem(&bufs[i]);
+			bufs[i].mem_handle = 0;
+		}
+
+		mutex_lock(&cb->lock);
+		rc = cam_smmu_check_buf_index(idx);
+		mutex_unlock(&cb->lock);
+		if (rc)
+			goto release;
+
+		for (i = 0; i < CAM_SMMU_CHURN_TEST_BUFS; i += 2) {
+			cam_mem_mgr_release_mem(&bufs[i]);
+			bufs[i].mem_handle = 0;
+		}
+	}
+
+release:
+	for (i = 0; i < CAM_SMMU_CHURN_TEST_BUFS; i++) {
+		if (bufs[i].mem_handle)
+			cam_mem_mgr_release_mem(&bufs[i]);
+	}
+
+	mutex_lock(&cb->lock);
+	check_rc = cam_smmu_check_buf_index(idx);
+	mutex_unlock(&cb->lock);
+
+	kfree(bufs);
+	return rc ? rc : check_rc;
+}
+
+static int cam_smmu_set_map_churn_test(void *data, u64 val)
+{
+	int idx, rc = 0, tested = 0;
+
+	for (idx = 0; idx < iommu_cb_set.cb_num; idx++) {
+		if ((iommu_cb_set.cb_info[idx].handle == HANDLE_INIT) ||
+			(iommu_cb_set.cb_info[idx].state != CAM_SMMU_ATTACH) ||
+			iommu_cb_set.cb_info[idx].is_secure ||
+			!(iommu_cb_set.cb_info[idx].shared_support ||
+			iommu_cb_set.cb_info[idx].io_support))
+			continue;
+
+		rc = cam_smmu_map_churn_test_cb(idx, val);
+		if (rc) {
+			CAM_ERR(CAM_SMMU, "map churn test failed on %s rc %d",
+				iommu_cb_set.cb_info[idx].name[0], rc);
+			return rc;
+		}
+		tested++;
+	}
+
+	CAM_INFO(CAM_SMMU, "map churn test passed on %d context banks, %llu iterations",
+		tested, val);
+	return 0;
+}
+
+static int cam_smmu_get_map_churn_test(void *data, u64 *val)
+{
+	return 0;
+}
+
+DEFINE_DEBUGFS_ATTRIBUTE(cam_smmu_map_churn_test,
+	cam_smmu_get_map_churn_test, cam_smmu_set_map_churn_test, "%08llu");
+
 static int cam_smmu_create_debug_fs(void)
 {
 	int rc = 0;
@@ -4533,6 +4721,10 @@ static int cam_smmu_create_debug_fs(void)
 		iommu_cb_set.debug_cfg.dentry, &iommu_cb_set.debug_cfg.map_profile_enable);
 	debugfs_create_file("fatal_pf_mask", 0644,
 		iommu_cb_set.debug_cfg.dentry, NULL, &cam_smmu_fatal_pf_mask);
+	debugfs_create_bool("map_index_check", 0644,
+		iommu_cb_set.debug_cfg.dentry, &iommu_cb_set.debug_cfg.map_index_check);
+	debugfs_create_file("map_churn_test", 0644,
+		iommu_cb_set.debug_cfg.dentry, NULL, &cam_smmu_map_churn_test);
 
 end:
 	return rc;
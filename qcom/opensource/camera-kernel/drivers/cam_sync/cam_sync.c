@@ -53,22 +53,18 @@ static int cam_sync_create_util(
 {
 	int rc;
 	long idx;
-	bool bit;
 	struct sync_table_row *row = NULL;
 
-	do {
-		idx = find_first_zero_bit(sync_dev->bitmap, CAM_SYNC_MAX_OBJS);
-		if (idx >= CAM_SYNC_MAX_OBJS) {
-			CAM_ERR(CAM_SYNC,
-				"Error: Unable to create sync idx = %d sync name = %s reached max!",
-				idx, name);
-			cam_sync_print_fence_table();
-			return -ENOMEM;
-		}
+	rc = cam_sync_util_find_and_set_empty_row(sync_dev, &idx);
+	if (rc) {
+		CAM_ERR(CAM_SYNC,
+			"Error: Unable to create sync idx = %d sync name = %s reached max!",
+			idx, name);
+		cam_sync_print_fence_table();
+		return -ENOMEM;
+	}
 
-		CAM_DBG(CAM_SYNC, "Index location available at idx: %ld", idx);
-		bit = test_and_set_bit(idx, sync_dev->bitmap);
-	} while (bit);
+	CAM_DBG(CAM_SYNC, "Index location available at idx: %ld", idx);
 
 	spin_lock_bh(&sync_dev->row_spinlocks[idx]);
 	rc = cam_sync_init_row(sync_dev->sync_table, idx, name,
@@ -397,7 +393,6 @@ int cam_sync_merge(int32_t *sync_obj, uint32_t num_objs, int32_t *merged_obj)
 {
 	int rc;
 	long idx = 0;
-	bool bit;
 	int i = 0;
 
 	if (!sync_obj || !merged_obj) {
@@ -424,12 +419,9 @@ int cam_sync_merge(int32_t *sync_obj, uint32_t num_objs, int32_t *merged_obj)
 			return rc;
 		}
 	}
-	do {
-		idx = find_first_zero_bit(sync_dev->bitmap, CAM_SYNC_MAX_OBJS);
-		if (idx >= CAM_SYNC_MAX_OBJS)
-			return -ENOMEM;
-		bit = test_and_set_bit(idx, sync_dev->bitmap);
-	} while (bit);
+	rc = cam_sync_util_find_and_set_empty_row(sync_dev, &idx);
+	if (rc)
+		return -ENOMEM;
 
 	spin_lock_bh(&sync_dev->row_spinlocks[idx]);
 	rc = cam_sync_init_group_object(sync_dev->sync_table,
@@ -1960,6 +1952,7 @@ static int cam_sync_component_bind(struct device *dev,
 	 * always
 	 */
 	set_bit(0, sync_dev->bitmap);
+	sync_dev->next_idx = 1;
 
 	sync_dev->work_queue = alloc_workqueue(CAM_SYNC_WORKQUEUE_NAME,
 		WQ_HIGHPRI | WQ_UNBOUND, 1);
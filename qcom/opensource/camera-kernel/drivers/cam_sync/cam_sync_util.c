@@ -11,20 +11,30 @@
 int cam_sync_util_find_and_set_empty_row(struct sync_device *sync_dev,
 	long *idx)
 {
-	int rc = 0;
-
-	mutex_lock(&sync_dev->table_lock);
+	long start = READ_ONCE(sync_dev->next_idx);
+	bool bit;
 
-	*idx = find_first_zero_bit(sync_dev->bitmap, CAM_SYNC_MAX_OBJS);
+	/*
+	 * Rows are claimed with test_and_set_bit, so no lock is needed.
+	 * The search starts past the last row handed out: low rows are
+	 * mostly busy, and a just destroyed handle is not reused at once.
+	 */
+	do {
+		*idx = find_next_zero_bit(sync_dev->bitmap, CAM_SYNC_MAX_OBJS,
+			start);
+		if (*idx >= CAM_SYNC_MAX_OBJS)
+			*idx = find_next_zero_bit(sync_dev->bitmap,
+				CAM_SYNC_MAX_OBJS, 1);
+		if (*idx >= CAM_SYNC_MAX_OBJS)
+			return -ENOMEM;
 
-	if (*idx < CAM_SYNC_MAX_OBJS)
-		set_bit(*idx, sync_dev->bitmap);
-	else
-		rc = -1;
+		bit = test_and_set_bit(*idx, sync_dev->bitmap);
+		start = *idx + 1;
+	} while (bit);
 
-	mutex_unlock(&sync_dev->table_lock);
+	WRITE_ONCE(sync_dev->next_idx, *idx + 1);
 
-	return rc;
+	return 0;
 }
 
 int cam_sync_init_row(struct sync_table_row *table,
@@ -6,6 +6,8 @@
 
 #include <linux/types.h>
 #include <linux/slab.h>
+#include <linux/debugfs.h>
+#include <linux/ktime.h>
 
 #include "cam_mem_mgr.h"
 #include "cam_packet_util.h"
@@ -360,6 +362,42 @@ static int cam_packet_util_get_patch_iova(
 	return rc;
 }
 
+/* cam_packet_util_patch_stats - patch processing counters, under
+ * g_patch_stats_lock
+ *
+ * @calls         : Number of cam_packet_util_process_patches() calls
+ * @patches       : Number of patches processed
+ * @dst_get       : Dst buffer lookups through the mem manager
+ * @dst_reuse     : Patches which reused the dst buffer already held
+ * @time_ns       : Total time spent processing patches
+ * @time_max_ns   : Longest time spent on the patches of one packet
+ */
+static struct {
+	u64 calls;
+	u64 patches;
+	u64 dst_get;
+	u64 dst_reuse;
+	u64 time_ns;
+	u64 time_max_ns;
+} g_patch_stats;
+
+static DEFINE_SPINLOCK(g_patch_stats_lock);
+
+void cam_packet_util_create_debugfs(struct dentry *dir)
+{
+	if (!dir)
+		return;
+
+	debugfs_create_u64("patch_calls", 0644, dir, &g_patch_stats.calls);
+	debugfs_create_u64("patch_count", 0644, dir, &g_patch_stats.patches);
+	debugfs_create_u64("patch_dst_get", 0644, dir, &g_patch_stats.dst_get);
+	debugfs_create_u64("patch_dst_reuse", 0644, dir,
+		&g_patch_stats.dst_reuse);
+	debugfs_create_u64("patch_time_ns", 0644, dir, &g_patch_stats.time_ns);
+	debugfs_create_u64("patch_time_max_ns", 0644, dir,
+		&g_patch_stats.time_max_ns);
+}
+
 int cam_packet_util_process_patches(struct cam_packet *packet,
 	int32_t iommu_hdl, int32_t sec_mmu_hdl, bool exp_mem)
 {
@@ -374,9 +412,15 @@ int cam_packet_util_process_patches(struct cam_packet *packet,
 	int        rc = 0;
 	uint32_t   flags = 0;
 	int32_t    hdl;
+	int32_t    dst_hdl = 0;
+	uint32_t   dst_get = 0;
+	uint32_t   dst_reuse = 0;
+	ktime_t    start;
+	u64        time_ns;
 	struct cam_patch_unique_src_buf_tbl
 		tbl[CAM_UNIQUE_SRC_HDL_MAX];
 
+	start = ktime_get();
 	memset(tbl, 0, CAM_UNIQUE_SRC_HDL_MAX *
 		sizeof(struct cam_patch_unique_src_buf_tbl));
 
@@ -398,23 +442,40 @@ int cam_packet_util_process_patches(struct cam_packet *packet,
 			CAM_ERR(CAM_UTIL,
 				"get_iova failed for patch[%d], src_buf_hdl: 0x%x: rc: %d",
 				i, patch_desc[i].src_buf_hdl, rc);
-			return rc;
+			goto put_dst;
 		}
 
 		if ((size_t)patch_desc[i].src_offset >= src_buf_size) {
 			CAM_ERR(CAM_UTIL,
 				"Invalid src buf patch offset: patch:src_offset: 0x%x, src_buf_size: %zu",
 				patch_desc[i].src_offset, src_buf_size);
-			return -EINVAL;
+			rc = -EINVAL;
+			goto put_dst;
 		}
 
 		temp = iova_addr;
 
-		rc = cam_mem_get_cpu_buf(patch_desc[i].dst_buf_hdl,
-			&cpu_addr, &dst_buf_len);
-		if (rc < 0 || !cpu_addr || (dst_buf_len == 0)) {
-			CAM_ERR(CAM_UTIL, "unable to get dst buf address");
-			return rc;
+		/*
+		 * Patches of a command buffer are usually grouped by dst
+		 * buffer, so keep the dst mapping held until the handle
+		 * changes instead of getting and putting it per patch.
+		 */
+		if (!cpu_addr ||
+			(dst_hdl != (int32_t)patch_desc[i].dst_buf_hdl)) {
+			if (cpu_addr)
+				cam_mem_put_cpu_buf(dst_hdl);
+			cpu_addr = 0;
+
+			dst_get++;
+			rc = cam_mem_get_cpu_buf(patch_desc[i].dst_buf_hdl,
+				&cpu_addr, &dst_buf_len);
+			if (rc < 0 || !cpu_addr || (dst_buf_len == 0)) {
+				CAM_ERR(CAM_UTIL, "unable to get dst buf address");
+				goto end;
+			}
+			dst_hdl = patch_desc[i].dst_buf_hdl;
+		} else {
+			dst_reuse++;
 		}
 		dst_cpu_addr = (uint32_t *)cpu_addr;
 
@@ -427,8 +488,8 @@ int cam_packet_util_process_patches(struct cam_packet *packet,
 			(size_t)patch_desc[i].dst_offset)) {
 			CAM_ERR(CAM_UTIL,
 				"Invalid dst buf patch offset");
-			cam_mem_put_cpu_buf((int32_t)patch_desc[i].dst_buf_hdl);
-			return -EINVAL;
+			rc = -EINVAL;
+			goto put_dst;
 		}
 
 		dst_cpu_addr = (uint32_t *)((uint8_t *)dst_cpu_addr +
@@ -457,9 +518,24 @@ int cam_packet_util_process_patches(struct cam_packet *packet,
 			CAM_BOOL_TO_YESNO(flags & CAM_MEM_FLAG_HW_SHARED_ACCESS),
 			CAM_BOOL_TO_YESNO(flags & CAM_MEM_FLAG_CMD_BUF_TYPE),
 			CAM_BOOL_TO_YESNO(flags & CAM_MEM_FLAG_HW_AND_CDM_OR_SHARED));
-		cam_mem_put_cpu_buf((int32_t)patch_desc[i].dst_buf_hdl);
 	}
 
+put_dst:
+	if (cpu_addr)
+		cam_mem_put_cpu_buf(dst_hdl);
+
+end:
+	time_ns = ktime_to_ns(ktime_sub(ktime_get(), start));
+	spin_lock_bh(&g_patch_stats_lock);
+	g_patch_stats.calls++;
+	g_patch_stats.patches += i;
+	g_patch_stats.dst_get += dst_get;
+	g_patch_stats.dst_reuse += dst_reuse;
+	g_patch_stats.time_ns += time_ns;
+	if (time_ns > g_patch_stats.time_max_ns)
+		g_patch_stats.time_max_ns = time_ns;
+	spin_unlock_bh(&g_patch_stats_lock);
+
 	return rc;
 }
 
@@ -10,6 +10,8 @@
 #include <media/cam_defs.h>
 #include "cam_hw_mgr_intf.h"
 
+struct dentry;
+
 /**
  * @brief                  KMD scratch buffer information
  *
@@ -142,6 +144,16 @@ void cam_packet_util_dump_patch_info(struct cam_packet *packet,
 int cam_packet_util_process_patches(struct cam_packet *packet,
 	int32_t iommu_hdl, int32_t sec_mmu_hdl, bool exp_mem);
 
+/**
+ * cam_packet_util_create_debugfs()
+ *
+ * @brief:              Create the patch processing counters, dst buffer
+ *                      lookups and reuses and time spent, in a debugfs folder
+ *
+ * @dir:                Debugfs folder to create the counters in
+ */
+void cam_packet_util_create_debugfs(struct dentry *dir);
+
 /**
  * cam_packet_util_dump_io_bufs()
  *
@@ -803,6 +803,24 @@ static void gsi_ring_chan_doorbell(struct gsi_chan_ctx *ctx)
 		gsi_ctx->per.ee, ctx->props.ch_id, val);
 }
 
+/*
+ * Account one interrupt on an event ring and the number of events it
+ * drained, so the ring's moderation settings can be judged from how many
+ * completions each interrupt actually covers.
+ * Called with the ring spinlock held.
+ */
+static void gsi_evt_irq_stats(struct gsi_evt_ctx *ctx, unsigned long events)
+{
+	ctx->stats.irqs++;
+	ctx->stats.irq_events += events;
+	if (events > ctx->stats.irq_events_max)
+		ctx->stats.irq_events_max = events;
+	if (!events)
+		ctx->stats.irq_empty++;
+
+	trace_gsi_evt_irq(ctx->id, events);
+}
+
 static bool check_channel_polling(struct gsi_evt_ctx* ctx) {
 	/* For shared event rings both channels will be marked */
 	return atomic_read(&ctx->chan[0]->poll_mode);
@@ -817,6 +835,7 @@ static void gsi_handle_ieob(int ee)
 	struct gsi_chan_xfer_notify notify;
 	unsigned long flags;
 	unsigned long cntr;
+	unsigned long events;
 	uint32_t msk;
 	bool empty;
 
@@ -862,6 +881,7 @@ static void gsi_handle_ieob(int ee)
 					}
 					spin_lock_irqsave(&ctx->ring.slock,
 							  flags);
+					events = 0;
 check_again_v3_0:
 					cntr = 0;
 					empty = true;
@@ -879,11 +899,13 @@ check_again_v3_0:
 						gsi_process_evt_re(ctx, &notify,
 								   true);
 						empty = false;
+						++events;
 					}
 					if (!empty)
 						gsi_ring_evt_doorbell(ctx);
 					if (cntr != 0)
 						goto check_again_v3_0;
+					gsi_evt_irq_stats(ctx, events);
 					spin_unlock_irqrestore(&ctx->ring.slock,
 							       flags);
 				}
@@ -916,6 +938,7 @@ check_again_v3_0:
 					GSI_ASSERT();
 				}
 				spin_lock_irqsave(&ctx->ring.slock, flags);
+				events = 0;
 			check_again:
 				cntr = 0;
 				empty = true;
@@ -932,11 +955,13 @@ check_again_v3_0:
 					}
 					gsi_process_evt_re(ctx, &notify, true);
 					empty = false;
+					++events;
 				}
 				if (!empty)
 					gsi_ring_evt_doorbell(ctx);
 				if (cntr != 0)
 					goto check_again;
+				gsi_evt_irq_stats(ctx, events);
 				spin_unlock_irqrestore(&ctx->ring.slock, flags);
 			}
 		}
@@ -1123,6 +1148,7 @@ static irqreturn_t gsi_msi_isr(int irq, void *ctxt)
 	struct gsi_chan_xfer_notify notify;
 	unsigned long flags;
 	unsigned long cntr;
+	unsigned long events = 0;
 	bool empty;
 	uint8_t evt;
 	unsigned long msi;
@@ -1173,11 +1199,13 @@ check_again:
 		}
 		gsi_process_evt_re(evt_ctxt, &notify, true);
 		empty = false;
+		++events;
 	}
 	if (!empty)
 		gsi_ring_evt_doorbell(evt_ctxt);
 	if (cntr != 0)
 		goto check_again;
+	gsi_evt_irq_stats(evt_ctxt, events);
 	spin_unlock_irqrestore(&evt_ctxt->ring.slock, flags);
 	return IRQ_HANDLED;
 }
@@ -2411,6 +2439,8 @@ int gsi_dealloc_evt_ring(unsigned long evt_ring_hdl)
 		for (msi = 0; msi < gsi_ctx->msi.num; msi++) {
 			if (gsi_ctx->msi.msg[msi].data == ctx->props.intvec) {
 				mutex_lock(&gsi_ctx->mlock);
+				/* drop an affinity set for this ring */
+				irq_set_affinity_hint(gsi_ctx->msi.irq[msi], NULL);
 				clear_bit(msi, gsi_ctx->msi.used);
 				gsi_ctx->msi.evt[msi] = 0;
 				clear_bit(evt_ring_hdl, &gsi_ctx->msi.mask);
@@ -5604,6 +5634,69 @@ int gsi_query_msi_addr(unsigned long chan_hdl, phys_addr_t *addr)
 }
 EXPORT_SYMBOL(gsi_query_msi_addr);
 
+int gsi_set_evt_ring_irq_affinity(unsigned long evt_ring_hdl, int cpu)
+{
+	struct gsi_evt_ctx *ctx;
+	int res = -GSI_STATUS_INVALID_PARAMS;
+	u32 msi;
+
+	if (!gsi_ctx) {
+		pr_err("%s:%d gsi context not allocated\n", __func__, __LINE__);
+		return -GSI_STATUS_NODEV;
+	}
+
+	if (evt_ring_hdl >= gsi_ctx->max_ev ||
+			evt_ring_hdl >= GSI_EVT_RING_MAX) {
+		GSIERR("bad params evt_ring_hdl=%lu\n", evt_ring_hdl);
+		return -GSI_STATUS_INVALID_PARAMS;
+	}
+
+	if (cpu >= 0 && (cpu >= nr_cpu_ids || !cpu_online(cpu))) {
+		GSIERR("bad params cpu=%d\n", cpu);
+		return -GSI_STATUS_INVALID_PARAMS;
+	}
+
+	ctx = &gsi_ctx->evtr[evt_ring_hdl];
+
+	if (ctx->state != GSI_EVT_RING_STATE_ALLOCATED) {
+		GSIERR("bad state %d\n", ctx->state);
+		return -GSI_STATUS_UNSUPPORTED_OP;
+	}
+
+	/* only MSI rings have an interrupt line of their own */
+	if (ctx->props.intf != GSI_EVT_CHTYPE_GPI_EV ||
+		ctx->props.intr != GSI_INTR_MSI) {
+		GSIDBG("evt %lu does not use an MSI\n", evt_ring_hdl);
+		return -GSI_STATUS_UNSUPPORTED_OP;
+	}
+
+	mutex_lock(&gsi_ctx->mlock);
+	for (msi = 0; msi < gsi_ctx->msi.num; msi++) {
+		if (!test_bit(msi, gsi_ctx->msi.used) ||
+			gsi_ctx->msi.evt[msi] != ctx->id)
+			continue;
+
+		res = irq_set_affinity_hint(gsi_ctx->msi.irq[msi],
+			(cpu >= 0) ? cpumask_of(cpu) : NULL);
+		if (res) {
+			GSIERR("evt %lu irq %u affinity to cpu %d failed %d\n",
+				evt_ring_hdl, gsi_ctx->msi.irq[msi], cpu, res);
+			res = -GSI_STATUS_ERROR;
+		} else {
+			GSIDBG("evt %lu irq %u affinity to cpu %d\n",
+				evt_ring_hdl, gsi_ctx->msi.irq[msi], cpu);
+		}
+		break;
+	}
+	mutex_unlock(&gsi_ctx->mlock);
+
+	if (msi == gsi_ctx->msi.num)
+		GSIERR("no MSI paired with evt %lu\n", evt_ring_hdl);
+
+	return res;
+}
+EXPORT_SYMBOL(gsi_set_evt_ring_irq_affinity);
+
 int gsi_query_device_msi_addr(u64 *addr)
 {
     if (!gsi_ctx) {
@@ -1457,6 +1457,10 @@ struct gsi_chan_ctx {
 
 struct gsi_evt_stats {
 	unsigned long completed;
+	unsigned long irqs;
+	unsigned long irq_events;
+	unsigned long irq_events_max;
+	unsigned long irq_empty;
 };
 
 struct gsi_evt_ctx {
@@ -2478,6 +2482,20 @@ int gsi_enable_flow_control_ee(unsigned int chan_idx, unsigned int ee,
 */
 int gsi_query_msi_addr(unsigned long chan_hdl, phys_addr_t *addr);
 
+/**
+* gsi_set_evt_ring_irq_affinity - steer the MSI of an event ring to a cpu
+*
+* @evt_ring_hdl: event ring handle
+* @cpu: online cpu to take the ring interrupt, negative to clear the
+*	affinity set before
+*
+* Only event rings using an MSI have an interrupt of their own; others
+* (IEOB rings and emulation) get -GSI_STATUS_UNSUPPORTED_OP.
+*
+* @Return gsi_status
+*/
+int gsi_set_evt_ring_irq_affinity(unsigned long evt_ring_hdl, int cpu);
+
 /**
 * gsi_query_device_msi_addr - get gsi device msi address
 *
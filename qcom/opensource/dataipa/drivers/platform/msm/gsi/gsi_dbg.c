@@ -147,6 +147,50 @@ static ssize_t gsi_dump_evt(struct file *file,
 	return count;
 }
 
+static ssize_t gsi_set_evt_irq_affinity(struct file *file,
+		const char __user *buf, size_t count, loff_t *ppos)
+{
+	u32 evt_id;
+	s32 cpu;
+	unsigned long missing;
+	char *sptr, *token;
+	int res;
+
+	if (count >= sizeof(dbg_buff))
+		return -EINVAL;
+
+	missing = copy_from_user(dbg_buff, buf, count);
+	if (missing)
+		return -EFAULT;
+
+	dbg_buff[count] = '\0';
+
+	sptr = dbg_buff;
+
+	token = strsep(&sptr, " ");
+	if (!token)
+		return -EINVAL;
+	if (kstrtou32(token, 0, &evt_id))
+		return -EINVAL;
+
+	token = strsep(&sptr, " ");
+	if (!token)
+		return -EINVAL;
+	if (kstrtos32(token, 0, &cpu))
+		return -EINVAL;
+
+	TDBG("evt_id=%u cpu=%d\n", evt_id, cpu);
+
+	res = gsi_set_evt_ring_irq_affinity(evt_id, cpu);
+	if (res) {
+		TERR("evt %u irq affinity to cpu %d failed %d\n",
+			evt_id, cpu, res);
+		return -EINVAL;
+	}
+
+	return count;
+}
+
 static ssize_t gsi_dump_ch(struct file *file,
 		const char __user *buf, size_t count, loff_t *ppos)
 {
@@ -231,9 +275,16 @@ static void gsi_dump_ch_stats(struct gsi_chan_ctx *ctx)
 		ctx->stats.invalid_tre_error);
 	PRT_STAT("poll_ok=%lu poll_empty=%lu\n",
 		ctx->stats.poll_ok, ctx->stats.poll_empty);
-	if (ctx->evtr)
+	if (ctx->evtr) {
 		PRT_STAT("compl_evt=%lu\n",
 			ctx->evtr->stats.completed);
+		PRT_STAT("evt_irqs=%lu evt_per_irq=%lu max=%lu empty=%lu\n",
+			ctx->evtr->stats.irqs,
+			ctx->evtr->stats.irqs ?
+			ctx->evtr->stats.irq_events / ctx->evtr->stats.irqs : 0,
+			ctx->evtr->stats.irq_events_max,
+			ctx->evtr->stats.irq_empty);
+	}
 	PRT_STAT("userdata_in_use=%lu\n", ctx->stats.userdata_in_use);
 
 	PRT_STAT("ch_below_lo=%lu\n", ctx->stats.dp.ch_below_lo);
@@ -683,6 +734,10 @@ static const struct file_operations gsi_ev_dump_ops = {
 	.write = gsi_dump_evt,
 };
 
+static const struct file_operations gsi_evt_irq_affinity_ops = {
+	.write = gsi_set_evt_irq_affinity,
+};
+
 static const struct file_operations gsi_ch_dump_ops = {
 	.write = gsi_dump_ch,
 };
@@ -738,6 +793,13 @@ void gsi_debugfs_init(void)
 		goto fail;
 	}
 
+	dfile = debugfs_create_file("evt_irq_affinity", write_only_mode,
+			dent, 0, &gsi_evt_irq_affinity_ops);
+	if (!dfile || IS_ERR(dfile)) {
+		TERR("fail to create evt_irq_affinity file\n");
+		goto fail;
+	}
+
 	dfile = debugfs_create_file("ch_dump", write_only_mode,
 			dent, 0, &gsi_ch_dump_ops);
 	if (!dfile || IS_ERR(dfile)) {
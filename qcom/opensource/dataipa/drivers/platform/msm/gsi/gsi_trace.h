@@ -44,6 +44,28 @@ TRACE_EVENT(
 		__entry->msk)
 );
 
+TRACE_EVENT(
+	gsi_evt_irq,
+
+	TP_PROTO(uint8_t evt, unsigned long events),
+
+	TP_ARGS(evt, events),
+
+	TP_STRUCT__entry(
+		__field(uint8_t,	evt)
+		__field(unsigned long,	events)
+	),
+
+	TP_fast_assign(
+		__entry->evt = evt;
+		__entry->events = events;
+	),
+
+	TP_printk("evt=%u, events=%lu",
+		__entry->evt,
+		__entry->events)
+);
+
 #endif /* _GSI_TRACE_H */
 
 /* This part must be outside protection */
@@ -5194,6 +5194,12 @@ static int ipa3_q6_clean_q6_tables(void)
 		return -EFAULT;
 	}
 
+	/* headers of pipes not owned by apps were overwritten, rewrite all */
+	mutex_lock(&ipa3_ctx->lock);
+	ipa3_flt_invalidate_tbls(IPA_IP_v4);
+	ipa3_flt_invalidate_tbls(IPA_IP_v6);
+	mutex_unlock(&ipa3_ctx->lock);
+
 	if (ipa3_q6_clean_q6_rt_tbls(IPA_IP_v4, IPA_RULE_HASHABLE)) {
 		IPAERR("failed to clean q6 rt tbls (v4/hashable)\n");
 		return -EFAULT;
@@ -9664,6 +9670,7 @@ static int ipa3_pre_init(const struct ipa3_plat_drv_res *resource_p,
 	/* Init the various list heads for both SRAM/DDR */
 	for (hdr_tbl = HDR_TBL_LCL; hdr_tbl < HDR_TBLS_TOTAL; hdr_tbl++) {
 		INIT_LIST_HEAD(&ipa3_ctx->hdr_tbl[hdr_tbl].head_hdr_entry_list);
+		hash_init(ipa3_ctx->hdr_tbl[hdr_tbl].name_ht);
 		for (i = 0; i < IPA_HDR_BIN_MAX; i++) {
 			INIT_LIST_HEAD(&ipa3_ctx->hdr_tbl[hdr_tbl].head_offset_list[i]);
 			INIT_LIST_HEAD(&ipa3_ctx->hdr_tbl[hdr_tbl].head_free_offset_list[i]);
@@ -9678,8 +9685,10 @@ static int ipa3_pre_init(const struct ipa3_plat_drv_res *resource_p,
 	}
 	INIT_LIST_HEAD(&ipa3_ctx->rt_tbl_set[IPA_IP_v4].head_rt_tbl_list);
 	idr_init(&ipa3_ctx->rt_tbl_set[IPA_IP_v4].rule_ids);
+	hash_init(ipa3_ctx->rt_tbl_set[IPA_IP_v4].name_ht);
 	INIT_LIST_HEAD(&ipa3_ctx->rt_tbl_set[IPA_IP_v6].head_rt_tbl_list);
 	idr_init(&ipa3_ctx->rt_tbl_set[IPA_IP_v6].rule_ids);
+	hash_init(ipa3_ctx->rt_tbl_set[IPA_IP_v6].name_ht);
 
 	rset = &ipa3_ctx->reap_rt_tbl_set[IPA_IP_v4];
 	INIT_LIST_HEAD(&rset->head_rt_tbl_list);
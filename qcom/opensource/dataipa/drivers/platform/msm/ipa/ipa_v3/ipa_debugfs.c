@@ -10,6 +10,7 @@
 #ifdef CONFIG_DEBUG_FS
 #include <linux/debugfs.h>
 #include <linux/kernel.h>
+#include <linux/math64.h>
 #include <linux/stringify.h>
 #include "ipa_rm_i.h"
 #include "ipahal_reg.h"
@@ -1635,6 +1636,15 @@ static ssize_t ipa3_read_odlstats(struct file *file, char __user *ubuf,
 }
 
 
+static u64 ipa3_page_recycle_rate(struct ipa3_page_recycle_stats *stats)
+{
+	if (!stats->total_replenished)
+		return 0;
+
+	return div64_u64(stats->page_recycled * 1000,
+		stats->total_replenished);
+}
+
 static ssize_t ipa3_read_page_recycle_stats(struct file *file,
 		char __user *ubuf, size_t count, loff_t *ppos)
 {
@@ -1647,11 +1657,15 @@ static ssize_t ipa3_read_page_recycle_stats(struct file *file,
 		"COAL   : Number of page recycled packets  =%llu\n"
 		"COAL   : Number of tmp alloc packets  =%llu\n"
 		"COAL   : Number of times tasklet scheduled  =%llu\n"
+		"COAL   : Number of busy pages rotated  =%llu\n"
+		"COAL   : Page recycle rate (per mille)  =%llu\n"
 
 		"DEF    : Total number of packets replenished =%llu\n"
 		"DEF    : Number of page recycled packets =%llu\n"
 		"DEF    : Number of tmp alloc packets  =%llu\n"
 		"DEF    : Number of times tasklet scheduled  =%llu\n"
+		"DEF    : Number of busy pages rotated  =%llu\n"
+		"DEF    : Page recycle rate (per mille)  =%llu\n"
 
 		"COMMON : Number of page recycled in tasklet  =%llu\n"
 		"COMMON : Number of times free pages not found in tasklet =%llu\n",
@@ -1660,11 +1674,15 @@ static ssize_t ipa3_read_page_recycle_stats(struct file *file,
 		ipa3_ctx->stats.page_recycle_stats[0].page_recycled,
 		ipa3_ctx->stats.page_recycle_stats[0].tmp_alloc,
 		ipa3_ctx->stats.num_sort_tasklet_sched[0],
+		ipa3_ctx->stats.page_recycle_stats[0].busy_rotated,
+		ipa3_page_recycle_rate(&ipa3_ctx->stats.page_recycle_stats[0]),
 
 		ipa3_ctx->stats.page_recycle_stats[1].total_replenished,
 		ipa3_ctx->stats.page_recycle_stats[1].page_recycled,
 		ipa3_ctx->stats.page_recycle_stats[1].tmp_alloc,
 		ipa3_ctx->stats.num_sort_tasklet_sched[1],
+		ipa3_ctx->stats.page_recycle_stats[1].busy_rotated,
+		ipa3_page_recycle_rate(&ipa3_ctx->stats.page_recycle_stats[1]),
 
 		ipa3_ctx->stats.page_recycle_cnt_in_tasklet,
 		ipa3_ctx->stats.num_of_times_wq_reschd);
@@ -1749,6 +1767,80 @@ static ssize_t ipa3_read_lan_coal_stats(
 	return simple_read_from_buffer(ubuf, count, ppos, dbg_buff, cnt);
 }
 
+static int ipa3_print_fltrt_cmt_stats(char *buf, int max_len,
+	const char *name, enum ipa_ip_type ip,
+	struct ipa3_fltrt_cmt_stats *stats)
+{
+	int nbytes;
+	int i;
+
+	nbytes = scnprintf(buf, max_len,
+		"%s v%d: commits=%llu skipped=%llu body_gen=%llu body_reused=%llu hdr_skipped=%llu\n"
+		"%s v%d: rule_gen=%llu rule_reused=%llu\n"
+		"%s v%d: latency usec (<limit:cnt)",
+		name, ip == IPA_IP_v4 ? 4 : 6, stats->commits, stats->skipped,
+		stats->body_gen, stats->body_reused, stats->hdr_skipped,
+		name, ip == IPA_IP_v4 ? 4 : 6, stats->rule_gen,
+		stats->rule_reused,
+		name, ip == IPA_IP_v4 ? 4 : 6);
+
+	for (i = 0; i < IPA_FLTRT_CMT_LAT_BUCKETS - 1; i++)
+		nbytes += scnprintf(buf + nbytes, max_len - nbytes,
+			" <%u:%llu", 2U << i, stats->lat[i]);
+	nbytes += scnprintf(buf + nbytes, max_len - nbytes, " more:%llu\n",
+		stats->lat[i]);
+
+	return nbytes;
+}
+
+static ssize_t ipa3_read_fltrt_cmt_stats(struct file *file,
+	char __user *ubuf, size_t count, loff_t *ppos)
+{
+	enum ipa_ip_type ip;
+	int cnt = 0;
+
+	mutex_lock(&ipa3_ctx->lock);
+	for (ip = IPA_IP_v4; ip < IPA_IP_MAX; ip++) {
+		cnt += ipa3_print_fltrt_cmt_stats(dbg_buff + cnt,
+			IPA_MAX_MSG_LEN - cnt, "FLT", ip,
+			&ipa3_ctx->stats.flt_cmt[ip]);
+		cnt += ipa3_print_fltrt_cmt_stats(dbg_buff + cnt,
+			IPA_MAX_MSG_LEN - cnt, "RT ", ip,
+			&ipa3_ctx->stats.rt_cmt[ip]);
+	}
+	mutex_unlock(&ipa3_ctx->lock);
+
+	return simple_read_from_buffer(ubuf, count, ppos, dbg_buff, cnt);
+}
+
+static ssize_t ipa3_read_tx_batch_stats(struct file *file,
+	char __user *ubuf, size_t count, loff_t *ppos)
+{
+	struct ipa3_ep_context *ep;
+	struct ipa3_tx_batch_stats *stats;
+	int cnt = 0;
+	int i, j;
+
+	for (i = 0; i < ipa3_ctx->ipa_num_pipes; i++) {
+		ep = &ipa3_ctx->ep[i];
+		if (!ep->valid || !ep->sys || !IPA_CLIENT_IS_PROD(ep->client))
+			continue;
+
+		stats = &ep->sys->tx_batch;
+		cnt += scnprintf(dbg_buff + cnt, IPA_MAX_MSG_LEN - cnt,
+			"%s: doorbells=%llu batches=%llu pkts=%llu max=%u sizes (<limit:cnt)",
+			ipa_clients_strings[ep->client], stats->doorbells,
+			stats->batches, stats->pkts, stats->max_pkts);
+		for (j = 0; j < IPA_TX_BATCH_BUCKETS - 1; j++)
+			cnt += scnprintf(dbg_buff + cnt, IPA_MAX_MSG_LEN - cnt,
+				" <%u:%llu", 2U << j, stats->size[j]);
+		cnt += scnprintf(dbg_buff + cnt, IPA_MAX_MSG_LEN - cnt,
+			" more:%llu\n", stats->size[j]);
+	}
+
+	return simple_read_from_buffer(ubuf, count, ppos, dbg_buff, cnt);
+}
+
 static ssize_t ipa3_read_cache_recycle_stats(
 	struct file *file,
 	char __user *ubuf,
@@ -3819,6 +3911,14 @@ static const struct ipa3_debugfs_file debugfs_files[] = {
 		"cache_recycle_stats", IPA_READ_ONLY_MODE, NULL, {
 			.read = ipa3_read_cache_recycle_stats,
 		}
+	}, {
+		"fltrt_cmt_stats", IPA_READ_ONLY_MODE, NULL, {
+			.read = ipa3_read_fltrt_cmt_stats,
+		}
+	}, {
+		"tx_batch_stats", IPA_READ_ONLY_MODE, NULL, {
+			.read = ipa3_read_tx_batch_stats,
+		}
 	}, {
 		"wdi", IPA_READ_ONLY_MODE, NULL, {
 			.read = ipa3_read_wdi,
@@ -592,43 +592,19 @@ static void ipa3_send_nop_desc(struct work_struct *work)
 }
 
 
-/**
- * ipa3_send() - Send multiple descriptors in one HW transaction
+/*
+ * ipa3_send_check_desc() - check a transfer fits what the channel of the
+ *  pipe can chain
  * @sys: system pipe context
- * @num_desc: number of packets
- * @desc: packets to send (may be immediate command or data)
- * @in_atomic:  whether caller is in atomic context
+ * @num_desc: number of descriptors of the transfer
  *
- * This function is used for GPI connection.
- * - ipa3_tx_pkt_wrapper will be used for each ipa
- *   descriptor (allocated from wrappers cache)
- * - The wrapper struct will be configured for each ipa-desc payload and will
- *   contain information which will be later used by the user callbacks
- * - Each packet (command or data) that will be sent will also be saved in
- *   ipa3_sys_context for later check that all data was sent
- *
- * Return codes: 0: success, -EFAULT: failure
+ * Return codes: 0: success, negative on failure
  */
-int ipa3_send(struct ipa3_sys_context *sys,
-		u32 num_desc,
-		struct ipa3_desc *desc,
-		bool in_atomic)
+static int ipa3_send_check_desc(struct ipa3_sys_context *sys, u32 num_desc)
 {
-	struct ipa3_tx_pkt_wrapper *tx_pkt, *tx_pkt_first = NULL;
-	struct ipahal_imm_cmd_pyld *tag_pyld_ret = NULL;
-	struct ipa3_tx_pkt_wrapper *next_pkt;
-	struct gsi_xfer_elem gsi_xfer[IPA_SEND_MAX_DESC];
-	int i = 0;
-	int j;
-	int result;
-	u32 mem_flag = GFP_ATOMIC;
 	const struct ipa_gsi_ep_config *gsi_ep_cfg;
-	bool send_nop = false;
 	unsigned int max_desc;
 
-	if (unlikely(!in_atomic))
-		mem_flag = GFP_KERNEL;
-
 	gsi_ep_cfg = ipa3_get_gsi_ep_info(sys->ep->client);
 	if (unlikely(!gsi_ep_cfg)) {
 		IPAERR("failed to get gsi EP config for client=%d\n",
@@ -654,16 +630,40 @@ int ipa3_send(struct ipa3_sys_context *sys,
 		return -EPERM;
 	}
 
-	/* initialize only the xfers we use */
-	memset(gsi_xfer, 0, sizeof(gsi_xfer[0]) * num_desc);
+	return 0;
+}
 
-	spin_lock_bh(&sys->spinlock);
+/*
+ * __ipa3_send() - queue the descriptors of one transfer on the channel
+ * @sys: system pipe context
+ * @num_desc: number of descriptors
+ * @desc: descriptors to queue
+ * @ring_db: ring the channel doorbell once queued
+ * @send_nop: [out] the NOP timer needs to be armed after the lock is dropped
+ *
+ * Caller validates the descriptors against the channel and holds
+ * sys->spinlock.
+ *
+ * Return codes: 0: success, negative on failure
+ */
+static int __ipa3_send(struct ipa3_sys_context *sys,
+		u32 num_desc,
+		struct ipa3_desc *desc,
+		bool ring_db,
+		bool *send_nop)
+{
+	struct ipa3_tx_pkt_wrapper *tx_pkt, *tx_pkt_first = NULL;
+	struct ipahal_imm_cmd_pyld *tag_pyld_ret = NULL;
+	struct ipa3_tx_pkt_wrapper *next_pkt;
+	struct gsi_xfer_elem gsi_xfer[IPA_SEND_MAX_DESC];
+	int i = 0;
+	int j;
+	int result;
 
-	if (unlikely(atomic_read(&sys->ep->disconnect_in_progress))) {
-		IPAERR("Pipe disconnect in progress dropping the packet\n");
-		spin_unlock_bh(&sys->spinlock);
-		return -EFAULT;
-	}
+	*send_nop = false;
+
+	/* initialize only the xfers we use */
+	memset(gsi_xfer, 0, sizeof(gsi_xfer[0]) * num_desc);
 
 	for (i = 0; i < num_desc; i++) {
 		if (!list_empty(&sys->avail_tx_wrapper_list)) {
@@ -774,7 +774,7 @@ int ipa3_send(struct ipa3_sys_context *sys,
 				hrtimer_try_to_cancel(&sys->db_timer);
 				sys->nop_pending = false;
 			} else {
-				send_nop = true;
+				*send_nop = true;
 			}
 			gsi_xfer[i].xfer_user_data =
 				tx_pkt_first;
@@ -786,32 +786,21 @@ int ipa3_send(struct ipa3_sys_context *sys,
 
 	IPADBG_LOW("ch:%lu queue xfer\n", sys->ep->gsi_chan_hdl);
 	result = gsi_queue_xfer(sys->ep->gsi_chan_hdl, num_desc,
-			gsi_xfer, true);
+			gsi_xfer, ring_db);
 	if (result != GSI_STATUS_SUCCESS) {
 		IPAERR_RL("GSI xfer failed.\n");
 		result = -EFAULT;
 		goto failure;
 	}
 
-	if (send_nop && !sys->nop_pending)
+	if (*send_nop && !sys->nop_pending)
 		sys->nop_pending = true;
 	else
-		send_nop = false;
+		*send_nop = false;
 
 	sys->pkt_sent++;
-	spin_unlock_bh(&sys->spinlock);
-
-	/* set the timer for sending the NOP descriptor */
-	if (send_nop) {
-		ktime_t time = ktime_set(0, IPA_TX_SEND_COMPL_NOP_DELAY_NS);
-
-		IPADBG_LOW("scheduling timer for ch %lu\n",
-			sys->ep->gsi_chan_hdl);
-		hrtimer_start(&sys->db_timer, time, HRTIMER_MODE_REL);
-	}
-
-	/* make sure TAG process is sent before clocks are gated */
-	ipa3_ctx->tag_process_before_gating = true;
+	if (ring_db)
+		sys->tx_batch.doorbells++;
 
 	return 0;
 
@@ -842,10 +831,70 @@ failure:
 		tx_pkt = next_pkt;
 	}
 
-	spin_unlock_bh(&sys->spinlock);
 	return result;
 }
 
+/**
+ * ipa3_send() - Send multiple descriptors in one HW transaction
+ * @sys: system pipe context
+ * @num_desc: number of packets
+ * @desc: packets to send (may be immediate command or data)
+ * @in_atomic:  whether caller is in atomic context
+ *
+ * This function is used for GPI connection.
+ * - ipa3_tx_pkt_wrapper will be used for each ipa
+ *   descriptor (allocated from wrappers cache)
+ * - The wrapper struct will be configured for each ipa-desc payload and will
+ *   contain information which will be later used by the user callbacks
+ * - Each packet (command or data) that will be sent will also be saved in
+ *   ipa3_sys_context for later check that all data was sent
+ *
+ * Return codes: 0: success, -EFAULT: failure
+ */
+int ipa3_send(struct ipa3_sys_context *sys,
+		u32 num_desc,
+		struct ipa3_desc *desc,
+		bool in_atomic)
+{
+	int result;
+	u32 mem_flag = GFP_ATOMIC;
+	bool send_nop;
+
+	if (unlikely(!in_atomic))
+		mem_flag = GFP_KERNEL;
+
+	result = ipa3_send_check_desc(sys, num_desc);
+	if (unlikely(result))
+		return result;
+
+	spin_lock_bh(&sys->spinlock);
+
+	if (unlikely(atomic_read(&sys->ep->disconnect_in_progress))) {
+		IPAERR("Pipe disconnect in progress dropping the packet\n");
+		spin_unlock_bh(&sys->spinlock);
+		return -EFAULT;
+	}
+
+	result = __ipa3_send(sys, num_desc, desc, true, &send_nop);
+	spin_unlock_bh(&sys->spinlock);
+	if (result)
+		return result;
+
+	/* set the timer for sending the NOP descriptor */
+	if (send_nop) {
+		ktime_t time = ktime_set(0, IPA_TX_SEND_COMPL_NOP_DELAY_NS);
+
+		IPADBG_LOW("scheduling timer for ch %lu\n",
+			sys->ep->gsi_chan_hdl);
+		hrtimer_start(&sys->db_timer, time, HRTIMER_MODE_REL);
+	}
+
+	/* make sure TAG process is sent before clocks are gated */
+	ipa3_ctx->tag_process_before_gating = true;
+
+	return 0;
+}
+
 /**
  * ipa3_send_one() - Send a single descriptor
  * @sys:	system pipe context
@@ -2255,52 +2304,19 @@ void ipa3_tx_cmd_comp(void *user1, int user2)
 	ipahal_destroy_imm_cmd(user1);
 }
 
-/**
- * ipa3_tx_dp() - Data-path tx handler
+/*
+ * ipa3_tx_dp_ep() - resolve the pipes a tx_dp destination is sent through
  * @dst:	[in] which IPA destination to route tx packets to
- * @skb:	[in] the packet to send
- * @metadata:	[in] TX packet meta-data
- *
- * Data-path tx handler, this is used for both SW data-path which by-passes most
- * IPA HW blocks AND the regular HW data-path for WLAN AMPDU traffic only. If
- * dst is a "valid" CONS type, then SW data-path is used. If dst is the
- * WLAN_AMPDU PROD type, then HW data-path for WLAN AMPDU is used. Anything else
- * is an error. For errors, client needs to free the skb as needed. For success,
- * IPA driver will later invoke client callback if one was supplied. That
- * callback should free the skb. If no callback supplied, IPA driver will free
- * the skb internally
- *
- * The function will use two descriptors for this send command
- * (for A5_WLAN_AMPDU_PROD only one desciprtor will be sent),
- * the first descriptor will be used to inform the IPA hardware that
- * apps need to push data into the IPA (IP_PACKET_INIT immediate command).
- * Once this send was done from transport point-of-view the IPA driver will
- * get notified by the supplied callback.
+ * @meta:	[in] TX packet meta-data
+ * @src_ep_idx:	[out] pipe the packets are pushed on
+ * @dst_ep_idx:	[out] PACKET_INIT destination pipe, -1 for HW data path
  *
- * Returns:	0 on success, negative on failure
+ * Returns:	0 on success, -EPIPE if the pipe is not valid, -EFAULT otherwise
  */
-int ipa3_tx_dp(enum ipa_client_type dst, struct sk_buff *skb,
-		struct ipa_tx_meta *meta)
+static int ipa3_tx_dp_ep(enum ipa_client_type dst, struct ipa_tx_meta *meta,
+	int *src_ep_idx, int *dst_ep_idx)
 {
-	struct ipa3_desc *desc;
-	struct ipa3_desc _desc[3];
-	int dst_ep_idx;
 	struct ipa3_sys_context *sys;
-	int src_ep_idx;
-	int num_frags, f;
-	const struct ipa_gsi_ep_config *gsi_ep;
-	int data_idx;
-	unsigned int max_desc;
-
-	if (unlikely(!ipa3_ctx)) {
-		IPAERR("IPA3 driver was not initialized\n");
-		return -EINVAL;
-	}
-
-	if (skb->len == 0) {
-		IPAERR("packet size is 0\n");
-		return -EINVAL;
-	}
 
 	/*
 	 * USB_CONS: PKT_INIT ep_idx = dst pipe
@@ -2312,33 +2328,50 @@ int ipa3_tx_dp(enum ipa_client_type dst, struct sk_buff *skb,
 	 *
 	 */
 	if (IPA_CLIENT_IS_CONS(dst)) {
-		src_ep_idx = ipa3_get_ep_mapping(IPA_CLIENT_APPS_LAN_PROD);
-		if (-1 == src_ep_idx) {
+		*src_ep_idx = ipa3_get_ep_mapping(IPA_CLIENT_APPS_LAN_PROD);
+		if (-1 == *src_ep_idx) {
 			IPAERR("Client %u is not mapped\n",
 				IPA_CLIENT_APPS_LAN_PROD);
-			goto fail_gen;
+			return -EFAULT;
 		}
-		dst_ep_idx = ipa3_get_ep_mapping(dst);
+		*dst_ep_idx = ipa3_get_ep_mapping(dst);
 	} else {
-		src_ep_idx = ipa3_get_ep_mapping(dst);
-		if (-1 == src_ep_idx) {
+		*src_ep_idx = ipa3_get_ep_mapping(dst);
+		if (-1 == *src_ep_idx) {
 			IPAERR("Client %u is not mapped\n", dst);
-			goto fail_gen;
+			return -EFAULT;
 		}
 		if (meta && meta->pkt_init_dst_ep_valid)
-			dst_ep_idx = meta->pkt_init_dst_ep;
+			*dst_ep_idx = meta->pkt_init_dst_ep;
 		else
-			dst_ep_idx = -1;
+			*dst_ep_idx = -1;
 	}
 
-	sys = ipa3_ctx->ep[src_ep_idx].sys;
+	sys = ipa3_ctx->ep[*src_ep_idx].sys;
 
 	if (!sys || !sys->ep->valid) {
-		IPAERR_RL("pipe %d not valid\n", src_ep_idx);
-		goto fail_pipe_not_valid;
+		IPAERR_RL("pipe %d not valid\n", *src_ep_idx);
+		return -EPIPE;
 	}
 
-	trace_ipa3_tx_dp(skb,sys->ep->client);
+	return 0;
+}
+
+/*
+ * ipa3_tx_dp_num_frags() - number of frags of the skb to send
+ * @skb:	[in] the packet to send
+ * @src_ep_idx:	[in] pipe the packet is pushed on
+ *
+ * The skb is linearized if its frags do not fit the TLV FIFO of the pipe.
+ *
+ * Returns:	number of frags on success, negative on failure
+ */
+static int ipa3_tx_dp_num_frags(struct sk_buff *skb, int src_ep_idx)
+{
+	const struct ipa_gsi_ep_config *gsi_ep;
+	unsigned int max_desc;
+	int num_frags;
+
 	num_frags = skb_shinfo(skb)->nr_frags;
 	/*
 	 * make sure TLV FIFO supports the needed frags.
@@ -2348,7 +2381,7 @@ int ipa3_tx_dp(enum ipa_client_type dst, struct sk_buff *skb,
 	gsi_ep = ipa3_get_gsi_ep_info(ipa3_ctx->ep[src_ep_idx].client);
 	if (unlikely(gsi_ep == NULL)) {
 		IPAERR("failed to get EP %d GSI info\n", src_ep_idx);
-		goto fail_gen;
+		return -EFAULT;
 	}
 	max_desc =  gsi_ep->ipa_if_tlv;
 	if (gsi_ep->prefetch_mode == GSI_SMART_PRE_FETCH ||
@@ -2358,46 +2391,50 @@ int ipa3_tx_dp(enum ipa_client_type dst, struct sk_buff *skb,
 		if (skb_linearize(skb)) {
 			IPAERR("Failed to linear skb with %d frags\n",
 				num_frags);
-			goto fail_gen;
+			return -EFAULT;
 		}
 		num_frags = 0;
 	}
-	if (num_frags) {
-		/* 1 desc for tag to resolve status out-of-order issue;
-		 * 1 desc is needed for the linear portion of skb;
-		 * 1 desc may be needed for the PACKET_INIT;
-		 * 1 desc for each frag
+
+	return num_frags;
+}
+
+/*
+ * ipa3_tx_dp_fill_desc() - build the descriptors of one tx_dp packet
+ * @sys:	[in] context of the pipe the packet is pushed on
+ * @skb:	[in] the packet to send
+ * @meta:	[in] TX packet meta-data
+ * @src_ep_idx:	[in] pipe the packet is pushed on
+ * @dst_ep_idx:	[in] PACKET_INIT destination pipe, -1 for HW data path
+ * @num_frags:	[in] frags of the skb to send
+ * @desc:	[out] zeroed array of at least num_frags + 3 descriptors
+ *
+ * Returns:	number of descriptors used
+ */
+static u32 ipa3_tx_dp_fill_desc(struct ipa3_sys_context *sys,
+	struct sk_buff *skb, struct ipa_tx_meta *meta, int src_ep_idx,
+	int dst_ep_idx, int num_frags, struct ipa3_desc *desc)
+{
+	struct iphdr *network_header;
+	int data_idx = 0;
+	int skb_idx;
+	int f;
+
+	if (sys->policy == IPA_POLICY_NOINTR_MODE) {
+		/*
+		 * For non-interrupt mode channel (where there is no
+		 * event ring) TAG STATUS are used for completion
+		 * notification. IPA will generate a status packet with
+		 * tag info as a result of the TAG STATUS command.
 		 */
-		desc = kzalloc(sizeof(*desc) * (num_frags + 3), GFP_ATOMIC);
-		if (!desc) {
-			IPAERR("failed to alloc desc array\n");
-			goto fail_gen;
-		}
-	} else {
-		memset(_desc, 0, 3 * sizeof(struct ipa3_desc));
-		desc = &_desc[0];
+		desc[data_idx].is_tag_status = true;
+		data_idx++;
 	}
 
 	if (dst_ep_idx != -1) {
 		/* SW data path */
-		int skb_idx;
-		struct iphdr *network_header;
-
 		network_header = (struct iphdr *)(skb_network_header(skb));
 
-		data_idx = 0;
-
-		if (sys->policy == IPA_POLICY_NOINTR_MODE) {
-			/*
-			 * For non-interrupt mode channel (where there is no
-			 * event ring) TAG STATUS are used for completion
-			 * notification. IPA will generate a status packet with
-			 * tag info as a result of the TAG STATUS command.
-			 */
-			desc[data_idx].is_tag_status = true;
-			data_idx++;
-		}
-
 		if ((ipa3_ctx->ipa_hw_type >= IPA_HW_v5_0) &&
 		    ((network_header->version == 4 &&
 		     network_header->protocol == IPPROTO_ICMP) ||
@@ -2422,97 +2459,129 @@ int ipa3_tx_dp(enum ipa_client_type dst, struct sk_buff *skb,
 		desc[data_idx].type = IPA_IMM_CMD_DESC;
 		desc[data_idx].callback = NULL;
 		data_idx++;
-		desc[data_idx].pyld = skb->data;
-		desc[data_idx].len = skb_headlen(skb);
-		desc[data_idx].type = IPA_DATA_DESC_SKB;
-		desc[data_idx].callback = ipa3_tx_comp_usr_notify_release;
-		desc[data_idx].user1 = skb;
+	}
+
+	desc[data_idx].pyld = skb->data;
+	desc[data_idx].len = skb_headlen(skb);
+	desc[data_idx].type = IPA_DATA_DESC_SKB;
+	desc[data_idx].callback = ipa3_tx_comp_usr_notify_release;
+	desc[data_idx].user1 = skb;
+	if (dst_ep_idx == -1)
+		desc[data_idx].user2 = src_ep_idx;
+	else
 		desc[data_idx].user2 = (meta && meta->pkt_init_dst_ep_valid &&
 				meta->pkt_init_dst_ep_remote) ?
 				src_ep_idx :
 				dst_ep_idx;
-		if (meta && meta->dma_address_valid) {
-			desc[data_idx].dma_address_valid = true;
-			desc[data_idx].dma_address = meta->dma_address;
-		}
+	if (meta && meta->dma_address_valid) {
+		desc[data_idx].dma_address_valid = true;
+		desc[data_idx].dma_address = meta->dma_address;
+	}
 
-		skb_idx = data_idx;
-		data_idx++;
+	skb_idx = data_idx;
+	data_idx++;
 
-		for (f = 0; f < num_frags; f++) {
-			desc[data_idx + f].frag = &skb_shinfo(skb)->frags[f];
-			desc[data_idx + f].type = IPA_DATA_DESC_SKB_PAGED;
-			desc[data_idx + f].len =
-				skb_frag_size(desc[data_idx + f].frag);
-		}
-		/* don't free skb till frag mappings are released */
-		if (num_frags) {
-			desc[data_idx + f - 1].callback =
-				desc[skb_idx].callback;
-			desc[data_idx + f - 1].user1 = desc[skb_idx].user1;
-			desc[data_idx + f - 1].user2 = desc[skb_idx].user2;
-			desc[skb_idx].callback = NULL;
-		}
+	for (f = 0; f < num_frags; f++) {
+		desc[data_idx + f].frag = &skb_shinfo(skb)->frags[f];
+		desc[data_idx + f].type = IPA_DATA_DESC_SKB_PAGED;
+		desc[data_idx + f].len =
+			skb_frag_size(desc[data_idx + f].frag);
+	}
+	/* don't free skb till frag mappings are released */
+	if (num_frags) {
+		desc[data_idx + f - 1].callback =
+			desc[skb_idx].callback;
+		desc[data_idx + f - 1].user1 = desc[skb_idx].user1;
+		desc[data_idx + f - 1].user2 = desc[skb_idx].user2;
+		desc[skb_idx].callback = NULL;
+	}
 
-		if (ipa3_send(sys, num_frags + data_idx, desc, true)) {
-			IPAERR_RL("fail to send skb %pK num_frags %u SWP\n",
-				skb, num_frags);
-			goto fail_send;
+	return data_idx + num_frags;
+}
+
+/**
+ * ipa3_tx_dp() - Data-path tx handler
+ * @dst:	[in] which IPA destination to route tx packets to
+ * @skb:	[in] the packet to send
+ * @metadata:	[in] TX packet meta-data
+ *
+ * Data-path tx handler, this is used for both SW data-path which by-passes most
+ * IPA HW blocks AND the regular HW data-path for WLAN AMPDU traffic only. If
+ * dst is a "valid" CONS type, then SW data-path is used. If dst is the
+ * WLAN_AMPDU PROD type, then HW data-path for WLAN AMPDU is used. Anything else
+ * is an error. For errors, client needs to free the skb as needed. For success,
+ * IPA driver will later invoke client callback if one was supplied. That
+ * callback should free the skb. If no callback supplied, IPA driver will free
+ * the skb internally
+ *
+ * The function will use two descriptors for this send command
+ * (for A5_WLAN_AMPDU_PROD only one desciprtor will be sent),
+ * the first descriptor will be used to inform the IPA hardware that
+ * apps need to push data into the IPA (IP_PACKET_INIT immediate command).
+ * Once this send was done from transport point-of-view the IPA driver will
+ * get notified by the supplied callback.
+ *
+ * Returns:	0 on success, negative on failure
+ */
+int ipa3_tx_dp(enum ipa_client_type dst, struct sk_buff *skb,
+		struct ipa_tx_meta *meta)
+{
+	struct ipa3_desc *desc;
+	struct ipa3_desc _desc[3];
+	int dst_ep_idx;
+	struct ipa3_sys_context *sys;
+	int src_ep_idx;
+	int num_frags;
+	u32 num_desc;
+	int ret;
+
+	if (unlikely(!ipa3_ctx)) {
+		IPAERR("IPA3 driver was not initialized\n");
+		return -EINVAL;
+	}
+
+	if (skb->len == 0) {
+		IPAERR("packet size is 0\n");
+		return -EINVAL;
+	}
+
+	ret = ipa3_tx_dp_ep(dst, meta, &src_ep_idx, &dst_ep_idx);
+	if (ret)
+		return ret;
+
+	sys = ipa3_ctx->ep[src_ep_idx].sys;
+
+	trace_ipa3_tx_dp(skb,sys->ep->client);
+	num_frags = ipa3_tx_dp_num_frags(skb, src_ep_idx);
+	if (num_frags < 0)
+		goto fail_gen;
+	if (num_frags) {
+		/* 1 desc for tag to resolve status out-of-order issue;
+		 * 1 desc is needed for the linear portion of skb;
+		 * 1 desc may be needed for the PACKET_INIT;
+		 * 1 desc for each frag
+		 */
+		desc = kzalloc(sizeof(*desc) * (num_frags + 3), GFP_ATOMIC);
+		if (!desc) {
+			IPAERR("failed to alloc desc array\n");
+			goto fail_gen;
 		}
-		IPA_STATS_INC_CNT(ipa3_ctx->stats.tx_sw_pkts);
 	} else {
-		/* HW data path */
-		data_idx = 0;
-		if (sys->policy == IPA_POLICY_NOINTR_MODE) {
-			/*
-			 * For non-interrupt mode channel (where there is no
-			 * event ring) TAG STATUS are used for completion
-			 * notification. IPA will generate a status packet with
-			 * tag info as a result of the TAG STATUS command.
-			 */
-			desc[data_idx].is_tag_status = true;
-			data_idx++;
-		}
-		desc[data_idx].pyld = skb->data;
-		desc[data_idx].len = skb_headlen(skb);
-		desc[data_idx].type = IPA_DATA_DESC_SKB;
-		desc[data_idx].callback = ipa3_tx_comp_usr_notify_release;
-		desc[data_idx].user1 = skb;
-		desc[data_idx].user2 = src_ep_idx;
+		memset(_desc, 0, 3 * sizeof(struct ipa3_desc));
+		desc = &_desc[0];
+	}
 
-		if (meta && meta->dma_address_valid) {
-			desc[data_idx].dma_address_valid = true;
-			desc[data_idx].dma_address = meta->dma_address;
-		}
-		if (num_frags == 0) {
-			if (ipa3_send(sys, data_idx + 1, desc, true)) {
-				IPAERR_RL("fail to send skb %pK HWP\n", skb);
-				goto fail_mem;
-			}
-		} else {
-			for (f = 0; f < num_frags; f++) {
-				desc[data_idx+f+1].frag =
-					&skb_shinfo(skb)->frags[f];
-				desc[data_idx+f+1].type =
-					IPA_DATA_DESC_SKB_PAGED;
-				desc[data_idx+f+1].len =
-					skb_frag_size(desc[data_idx+f+1].frag);
-			}
-			/* don't free skb till frag mappings are released */
-			desc[data_idx+f].callback = desc[data_idx].callback;
-			desc[data_idx+f].user1 = desc[data_idx].user1;
-			desc[data_idx+f].user2 = desc[data_idx].user2;
-			desc[data_idx].callback = NULL;
-
-			if (ipa3_send(sys, num_frags + data_idx + 1,
-				desc, true)) {
-				IPAERR_RL("fail to send skb %pK num_frags %u\n",
-					skb, num_frags);
-				goto fail_mem;
-			}
-		}
-		IPA_STATS_INC_CNT(ipa3_ctx->stats.tx_hw_pkts);
+	num_desc = ipa3_tx_dp_fill_desc(sys, skb, meta, src_ep_idx, dst_ep_idx,
+		num_frags, desc);
+	if (ipa3_send(sys, num_desc, desc, true)) {
+		IPAERR_RL("fail to send skb %pK num_frags %u %s\n",
+			skb, num_frags, dst_ep_idx != -1 ? "SWP" : "HWP");
+		goto fail_send;
 	}
+	if (dst_ep_idx != -1)
+		IPA_STATS_INC_CNT(ipa3_ctx->stats.tx_sw_pkts);
+	else
+		IPA_STATS_INC_CNT(ipa3_ctx->stats.tx_hw_pkts);
 
 	trace_ipa3_tx_done(sys->ep->client);
 	if (num_frags) {
@@ -2522,13 +2591,142 @@ int ipa3_tx_dp(enum ipa_client_type dst, struct sk_buff *skb,
 	return 0;
 
 fail_send:
-fail_mem:
 	if (num_frags)
 		kfree(desc);
 fail_gen:
 	return -EFAULT;
-fail_pipe_not_valid:
-	return -EPIPE;
+}
+
+/**
+ * ipa3_tx_dp_list() - Data-path tx handler for a list of packets
+ * @dst:	[in] which IPA destination to route tx packets to
+ * @skbs:	[in/out] the packets to send, in order
+ * @meta:	[in] TX packet meta-data, common to all the packets
+ *
+ * Same as calling ipa3_tx_dp() for each packet of the list, except that
+ * the pipe lock is taken once and the channel doorbell is rung once for
+ * all the packets queued.
+ *
+ * Packets are removed from @skbs as they are queued. On failure the ones
+ * which were not queued are left on @skbs, in order, and the client needs
+ * to free or resend them, as with ipa3_tx_dp().
+ *
+ * Returns:	0 if all the packets were queued, -EPIPE if the pipe is not
+ * valid, other negative value on other failures
+ */
+int ipa3_tx_dp_list(enum ipa_client_type dst, struct sk_buff_head *skbs,
+		struct ipa_tx_meta *meta)
+{
+	struct ipa3_desc *desc;
+	struct ipa3_desc _desc[3];
+	struct ipa3_sys_context *sys;
+	struct sk_buff *skb;
+	int src_ep_idx, dst_ep_idx;
+	int num_frags;
+	u32 num_desc, cnt = 0;
+	bool send_nop, arm_nop = false;
+	int ret;
+
+	if (unlikely(!ipa3_ctx)) {
+		IPAERR("IPA3 driver was not initialized\n");
+		return -EINVAL;
+	}
+
+	if (skb_queue_empty(skbs))
+		return 0;
+
+	ret = ipa3_tx_dp_ep(dst, meta, &src_ep_idx, &dst_ep_idx);
+	if (ret)
+		return ret;
+
+	sys = ipa3_ctx->ep[src_ep_idx].sys;
+
+	spin_lock_bh(&sys->spinlock);
+
+	if (unlikely(atomic_read(&sys->ep->disconnect_in_progress))) {
+		IPAERR("Pipe disconnect in progress dropping the packet\n");
+		spin_unlock_bh(&sys->spinlock);
+		return -EFAULT;
+	}
+
+	while ((skb = skb_peek(skbs)) != NULL) {
+		if (skb->len == 0) {
+			IPAERR("packet size is 0\n");
+			ret = -EINVAL;
+			break;
+		}
+
+		trace_ipa3_tx_dp(skb, sys->ep->client);
+		num_frags = ipa3_tx_dp_num_frags(skb, src_ep_idx);
+		if (num_frags < 0) {
+			ret = -EFAULT;
+			break;
+		}
+		if (num_frags) {
+			desc = kzalloc(sizeof(*desc) * (num_frags + 3),
+				GFP_ATOMIC);
+			if (!desc) {
+				IPAERR("failed to alloc desc array\n");
+				ret = -ENOMEM;
+				break;
+			}
+		} else {
+			memset(_desc, 0, 3 * sizeof(struct ipa3_desc));
+			desc = &_desc[0];
+		}
+
+		num_desc = ipa3_tx_dp_fill_desc(sys, skb, meta, src_ep_idx,
+			dst_ep_idx, num_frags, desc);
+		ret = ipa3_send_check_desc(sys, num_desc);
+		if (!ret)
+			ret = __ipa3_send(sys, num_desc, desc, false,
+				&send_nop);
+		if (num_frags)
+			kfree(desc);
+		if (ret) {
+			IPAERR_RL("fail to send skb %pK num_frags %u\n",
+				skb, num_frags);
+			break;
+		}
+
+		__skb_unlink(skb, skbs);
+		arm_nop |= send_nop;
+		cnt++;
+		if (dst_ep_idx != -1)
+			IPA_STATS_INC_CNT(ipa3_ctx->stats.tx_sw_pkts);
+		else
+			IPA_STATS_INC_CNT(ipa3_ctx->stats.tx_hw_pkts);
+		if (num_frags)
+			IPA_STATS_INC_CNT(ipa3_ctx->stats.tx_non_linear);
+		trace_ipa3_tx_done(sys->ep->client);
+	}
+
+	if (cnt) {
+		/* one doorbell for all the packets queued above */
+		if (gsi_start_xfer(sys->ep->gsi_chan_hdl) != GSI_STATUS_SUCCESS)
+			IPAERR_RL("failed to ring ch %lu doorbell\n",
+				sys->ep->gsi_chan_hdl);
+		sys->tx_batch.doorbells++;
+		ipa3_tx_batch_stats_inc(&sys->tx_batch, cnt);
+	}
+	spin_unlock_bh(&sys->spinlock);
+
+	if (!cnt)
+		return ret;
+
+	/* set the timer for sending the NOP descriptor */
+	if (arm_nop) {
+		ktime_t time = ktime_set(0, IPA_TX_SEND_COMPL_NOP_DELAY_NS);
+
+		IPADBG_LOW("scheduling timer for ch %lu\n",
+			sys->ep->gsi_chan_hdl);
+		hrtimer_start(&sys->db_timer, time, HRTIMER_MODE_REL);
+	}
+
+	/* make sure TAG process is sent before clocks are gated */
+	ipa3_ctx->tag_process_before_gating = true;
+
+	return ret;
 }
 
 static void ipa3_wq_handle_rx(struct work_struct *work)
@@ -2787,6 +2985,24 @@ static inline void __trigger_repl_work(struct ipa3_sys_context *sys)
 	}
 }
 
+/*
+ * Pages go back to the tail of the recycle list when they are handed to the
+ * stack, so the list is roughly ordered by the time each page was last
+ * used. Pages the stack still holds at the head are moved behind the others
+ * so the next scans look at pages more likely to have been released,
+ * instead of stopping on the same busy ones every time.
+ * Caller holds the common_sys spinlock.
+ */
+static void ipa3_rotate_busy_pages(struct ipa3_sys_context *sys,
+	struct list_head *busy, int cnt, u32 stats_i)
+{
+	if (!cnt)
+		return;
+
+	list_splice_tail_init(busy, &sys->page_recycle_repl->page_repl_head);
+	ipa3_ctx->stats.page_recycle_stats[stats_i].busy_rotated += cnt;
+}
+
 static struct ipa3_rx_pkt_wrapper * ipa3_get_free_page
 (
 	struct ipa3_sys_context *sys,
@@ -2796,9 +3012,11 @@ static struct ipa3_rx_pkt_wrapper * ipa3_get_free_page
 	struct ipa3_rx_pkt_wrapper *rx_pkt = NULL;
 	struct ipa3_rx_pkt_wrapper *tmp = NULL;
 	struct page *cur_page;
+	struct list_head busy;
 	int i = 0;
 	u8 LOOP_THRESHOLD = ipa3_ctx->page_poll_threshold;
 
+	INIT_LIST_HEAD(&busy);
 	spin_lock_bh(&sys->common_sys->spinlock);
 	list_for_each_entry_safe(rx_pkt, tmp,
 		&sys->page_recycle_repl->page_repl_head, link) {
@@ -2811,11 +3029,15 @@ static struct ipa3_rx_pkt_wrapper * ipa3_get_free_page
 			list_del_init(&rx_pkt->link);
 			++ipa3_ctx->stats.page_recycle_cnt[stats_i][i];
 			sys->common_sys->napi_sort_page_thrshld_cnt = 0;
+			ipa3_rotate_busy_pages(sys, &busy, i, stats_i);
 			spin_unlock_bh(&sys->common_sys->spinlock);
 			return rx_pkt;
 		}
+		/* still held by the stack, look at it again last */
+		list_move_tail(&rx_pkt->link, &busy);
 		i++;
 	}
+	ipa3_rotate_busy_pages(sys, &busy, i, stats_i);
 	spin_unlock_bh(&sys->common_sys->spinlock);
 	IPADBG_LOW("napi_sort_page_thrshld_cnt = %d ipa_max_napi_sort_page_thrshld = %d\n",
 			sys->common_sys->napi_sort_page_thrshld_cnt,
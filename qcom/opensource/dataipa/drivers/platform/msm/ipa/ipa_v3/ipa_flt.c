@@ -18,6 +18,24 @@
 	(IPA_RULE_HASHABLE):(IPA_RULE_NON_HASHABLE) \
 	)
 
+/*
+ * mark a table as changed so the next commit prepares it again and
+ * regenerates its system memory bodies
+ */
+static void ipa3_flt_tbl_set_dirty(struct ipa3_flt_tbl *tbl)
+{
+	tbl->dirty = true;
+	tbl->body_valid[IPA_RULE_HASHABLE] = false;
+	tbl->body_valid[IPA_RULE_NON_HASHABLE] = false;
+}
+
+/* forget the H/W format kept for the entry, its rule changed or it goes */
+static void ipa3_flt_drop_hw_rule(struct ipa3_flt_entry *entry)
+{
+	kfree(entry->hw_rule);
+	entry->hw_rule = NULL;
+}
+
 /**
  * ipa3_generate_flt_hw_rule() - generates the filtering hardware rule
  * @ip: the ip address family type
@@ -40,6 +58,7 @@ static int ipa3_generate_flt_hw_rule(enum ipa_ip_type ip,
 		struct ipa3_flt_entry *entry, u8 *buf)
 {
 	struct ipahal_flt_rule_gen_params gen_params;
+	u8 *scratch = NULL;
 	int res = 0;
 
 	memset(&gen_params, 0, sizeof(gen_params));
@@ -75,15 +94,84 @@ static int ipa3_generate_flt_hw_rule(enum ipa_ip_type ip,
 	gen_params.rule = (const struct ipa_flt_rule_i *)&entry->rule;
 	gen_params.cnt_idx = entry->cnt_idx;
 
-	res = ipahal_flt_generate_hw_rule(&gen_params, &entry->hw_len, buf);
+	if (entry->hw_rule &&
+		!memcmp(&entry->hw_key, &gen_params, sizeof(gen_params))) {
+		ipa3_ctx->stats.flt_cmt[ip].rule_reused++;
+		if (!buf)
+			return 0;
+		return ipahal_fltrt_write_hw_rule(entry->hw_rule,
+			entry->hw_len, buf);
+	}
+
+	ipa3_flt_drop_hw_rule(entry);
+	if (!buf) {
+		scratch = kzalloc(ipahal_get_hw_rule_buf_size(), GFP_KERNEL);
+		if (!scratch)
+			return -ENOMEM;
+	}
+
+	res = ipahal_flt_generate_hw_rule(&gen_params, &entry->hw_len,
+		buf ? buf : scratch);
 	if (res) {
 		IPAERR_RL("failed to generate flt h/w rule\n");
+		kfree(scratch);
 		return res;
 	}
 
+	ipa3_ctx->stats.flt_cmt[ip].rule_gen++;
+	/* keeping the rule is best effort, it is regenerated if absent */
+	entry->hw_rule = kmemdup(buf ? buf : scratch, entry->hw_len,
+		GFP_KERNEL);
+	if (entry->hw_rule)
+		memcpy(&entry->hw_key, &gen_params, sizeof(gen_params));
+
+	kfree(scratch);
 	return 0;
 }
 
+/**
+ * ipa3_flt_verify_hw_rules() - check the H/W format rules kept by the
+ *  filtering entries against freshly generated ones
+ * @ip: the ip address family type
+ *
+ * Return: 0 if all kept rules match, negative otherwise
+ *
+ * caller needs to hold any needed locks to ensure integrity
+ */
+int ipa3_flt_verify_hw_rules(enum ipa_ip_type ip)
+{
+	struct ipa3_flt_tbl *tbl;
+	struct ipa3_flt_entry *entry;
+	u32 hw_len;
+	u8 *buf;
+	int i;
+	int rc = 0;
+
+	buf = kzalloc(ipahal_get_hw_rule_buf_size(), GFP_KERNEL);
+	if (!buf)
+		return -ENOMEM;
+
+	for (i = 0; i < ipa3_ctx->ipa_num_pipes; i++) {
+		if (!ipa_is_ep_support_flt(i))
+			continue;
+		tbl = &ipa3_ctx->flt_tbl[i][ip];
+		list_for_each_entry(entry, &tbl->head_flt_rule_list, link) {
+			if (!entry->hw_rule)
+				continue;
+			if (ipahal_flt_generate_hw_rule(&entry->hw_key,
+				&hw_len, buf) || hw_len != entry->hw_len ||
+				memcmp(buf, entry->hw_rule, hw_len)) {
+				IPAERR("flt rule %d pipe %d ip=%d mismatch\n",
+					entry->rule_id, i, ip);
+				rc = -EFAULT;
+			}
+		}
+	}
+
+	kfree(buf);
+	return rc;
+}
+
 static void __ipa_reap_sys_flt_tbls(enum ipa_ip_type ip, enum ipa_rule_type rlt)
 {
 	struct ipa3_flt_tbl *tbl;
@@ -106,6 +194,7 @@ static void __ipa_reap_sys_flt_tbls(enum ipa_ip_type ip, enum ipa_rule_type rlt)
 				IPADBG_LOW("reaping flt tbl (curr) pipe=%d\n",
 					i);
 				ipahal_free_dma_mem(&tbl->curr_mem[rlt]);
+				tbl->body_valid[rlt] = false;
 			}
 		}
 	}
@@ -119,6 +208,9 @@ static void __ipa_reap_sys_flt_tbls(enum ipa_ip_type ip, enum ipa_rule_type rlt)
  * @tbl: the flt tbl to be prepared
  * @pipe_idx: the ep pipe appropriate for the given tbl
  *
+ * Tables which did not change since they were last committed keep their
+ * priorities and sizes.
+ *
  * Return: 0 on success, negative on failure
  */
 static int ipa_prep_flt_tbl_for_cmt(enum ipa_ip_type ip,
@@ -129,6 +221,9 @@ static int ipa_prep_flt_tbl_for_cmt(enum ipa_ip_type ip,
 	int max_prio;
 	u32 hdr_width;
 
+	if (!tbl->dirty)
+		return 0;
+
 	tbl->sz[IPA_RULE_HASHABLE] = 0;
 	tbl->sz[IPA_RULE_NON_HASHABLE] = 0;
 
@@ -182,6 +277,33 @@ static int ipa_prep_flt_tbl_for_cmt(enum ipa_ip_type ip,
 	return 0;
 }
 
+/**
+ * ipa_generate_flt_tbl_body() - generate the rules of a table into a buffer
+ * @ip: the ip address family type
+ * @tbl: the flt tbl to generate
+ * @rlt: the type of the rules to generate (hashable or non-hashable)
+ * @buf: the buffer to be filled, sized per the last prepare of the table
+ *
+ * Returns: 0 on success, negative on failure
+ */
+static int ipa_generate_flt_tbl_body(enum ipa_ip_type ip,
+	struct ipa3_flt_tbl *tbl, enum ipa_rule_type rlt, u8 *buf)
+{
+	struct ipa3_flt_entry *entry;
+
+	list_for_each_entry(entry, &tbl->head_flt_rule_list, link) {
+		if (IPA_FLT_GET_RULE_TYPE(entry) != rlt)
+			continue;
+		if (ipa3_generate_flt_hw_rule(ip, entry, buf)) {
+			IPAERR("failed to gen HW FLT rule\n");
+			return -EPERM;
+		}
+		buf += entry->hw_len;
+	}
+
+	return 0;
+}
+
 /**
  * ipa_translate_flt_tbl_to_hw_fmt() - translate the flt driver structures
  *  (rules and tables) to HW format and fill it in the given buffers
@@ -192,6 +314,9 @@ static int ipa_prep_flt_tbl_for_cmt(enum ipa_ip_type ip,
  * @body_ofst: the offset of the rules body from the rules header at
  *  ipa sram
  *
+ * System memory bodies of tables which did not change since they were
+ * generated are kept and only their address is written to the header.
+ *
  * Returns: 0 on success, negative on failure
  *
  * caller needs to hold any needed locks to ensure integrity
@@ -204,7 +329,6 @@ static int ipa_translate_flt_tbl_to_hw_fmt(enum ipa_ip_type ip,
 	u8 *body_i;
 	int res;
 	struct ipa3_flt_entry *entry;
-	u8 *tbl_mem_buf;
 	struct ipa_mem_buffer tbl_mem;
 	struct ipa3_flt_tbl *tbl;
 	int i;
@@ -219,7 +343,16 @@ static int ipa_translate_flt_tbl_to_hw_fmt(enum ipa_ip_type ip,
 			hdr_idx++;
 			continue;
 		}
-		if (tbl->in_sys[rlt] || tbl->force_sys[rlt]) {
+		if ((tbl->in_sys[rlt] || tbl->force_sys[rlt]) &&
+			tbl->body_valid[rlt] && tbl->curr_mem[rlt].phys_base) {
+			if (ipahal_fltrt_write_addr_to_hdr(
+				tbl->curr_mem[rlt].phys_base, hdr, hdr_idx,
+				true)) {
+				IPAERR("fail to wrt sys tbl addr to hdr\n");
+				goto err;
+			}
+			ipa3_ctx->stats.flt_cmt[ip].body_reused++;
+		} else if (tbl->in_sys[rlt] || tbl->force_sys[rlt]) {
 			/* only body (no header) */
 			tbl_mem.size = tbl->sz[rlt] -
 				ipahal_get_hw_tbl_hdr_width();
@@ -238,27 +371,18 @@ static int ipa_translate_flt_tbl_to_hw_fmt(enum ipa_ip_type ip,
 				goto hdr_update_fail;
 			}
 
-			tbl_mem_buf = tbl_mem.base;
-
 			/* generate the rule-set */
-			list_for_each_entry(entry, &tbl->head_flt_rule_list,
-				link) {
-				if (IPA_FLT_GET_RULE_TYPE(entry) != rlt)
-					continue;
-				res = ipa3_generate_flt_hw_rule(
-					ip, entry, tbl_mem_buf);
-				if (res) {
-					IPAERR("failed to gen HW FLT rule\n");
-					goto hdr_update_fail;
-				}
-				tbl_mem_buf += entry->hw_len;
-			}
+			if (ipa_generate_flt_tbl_body(ip, tbl, rlt,
+				tbl_mem.base))
+				goto hdr_update_fail;
 
 			if (tbl->curr_mem[rlt].phys_base) {
 				WARN_ON(tbl->prev_mem[rlt].phys_base);
 				tbl->prev_mem[rlt] = tbl->curr_mem[rlt];
 			}
 			tbl->curr_mem[rlt] = tbl_mem;
+			tbl->body_valid[rlt] = true;
+			ipa3_ctx->stats.flt_cmt[ip].body_gen++;
 		} else {
 			offset = body_i - base + body_ofst;
 
@@ -470,6 +594,40 @@ static bool ipa_flt_skip_pipe_config(int pipe)
 	return false;
 }
 
+/**
+ * ipa_flt_hdr_unchanged() - check if the sram holds the headers of a pipe
+ * @tbl: the flt tbl of the pipe
+ * @alloc_params: the header images generated for this commit
+ * @hdr_idx: the index of the pipe in the header images
+ *
+ * The headers generated for this commit are kept in @tbl; the caller marks
+ * them valid once they were written.
+ *
+ * Return: true if the sram already holds the same headers
+ */
+static bool ipa_flt_hdr_unchanged(struct ipa3_flt_tbl *tbl,
+	struct ipahal_fltrt_alloc_imgs_params *alloc_params, int hdr_idx)
+{
+	u32 width = ipahal_get_hw_tbl_hdr_width();
+	u64 hdr[IPA_RULE_TYPE_MAX] = {0};
+
+	if (width > sizeof(hdr[0]))
+		return false;
+
+	memcpy(&hdr[IPA_RULE_NON_HASHABLE],
+		alloc_params->nhash_hdr.base + hdr_idx * width, width);
+	if (!ipa3_ctx->ipa_fltrt_not_hashable)
+		memcpy(&hdr[IPA_RULE_HASHABLE],
+			alloc_params->hash_hdr.base + hdr_idx * width, width);
+
+	if (tbl->hdr_valid && !memcmp(hdr, tbl->hdr, sizeof(hdr)))
+		return true;
+
+	tbl->hdr_valid = false;
+	memcpy(tbl->hdr, hdr, sizeof(hdr));
+	return false;
+}
+
 /**
  * __ipa_commit_flt_v3() - commit flt tables to the hw
  *  commit the headers and the bodies if are local with internal cache flushing.
@@ -499,6 +657,8 @@ int __ipa_commit_flt_v3(enum ipa_ip_type ip)
 	struct ipa3_flt_tbl_nhash_lcl *lcl_tbl;
 	u16 entries;
 	struct ipahal_imm_cmd_register_write reg_write_coal_close;
+	ktime_t start = ktime_get();
+	bool changed = false;
 
 	tbl_hdr_width = ipahal_get_hw_tbl_hdr_width();
 	memset(&alloc_params, 0, sizeof(alloc_params));
@@ -537,6 +697,8 @@ int __ipa_commit_flt_v3(enum ipa_ip_type ip)
 		if (!ipa_is_ep_support_flt(i))
 			continue;
 		tbl = &ipa3_ctx->flt_tbl[i][ip];
+		changed |= tbl->dirty ||
+			(!tbl->hdr_valid && !ipa_flt_skip_pipe_config(i));
 		if (ipa_prep_flt_tbl_for_cmt(ip, tbl, i)) {
 			rc = -EPERM;
 			goto prep_failed;
@@ -591,6 +753,12 @@ int __ipa_commit_flt_v3(enum ipa_ip_type ip)
 		alloc_params.total_sz_lcl_nhash_tbls += tbl_hdr_width;
 	}
 
+	if (!changed) {
+		IPADBG_LOW("no flt tbl changed, skip commit. IP %d\n", ip);
+		ipa3_ctx->stats.flt_cmt[ip].skipped++;
+		goto prep_failed;
+	}
+
 	if (ipa_generate_flt_hw_tbl_img(ip, &alloc_params)) {
 		IPAERR_RL("fail to generate FLT HW TBL image. IP %d\n", ip);
 		rc = -EFAULT;
@@ -689,7 +857,18 @@ int __ipa_commit_flt_v3(enum ipa_ip_type ip)
 			continue;
 		}
 
+		tbl = &ipa3_ctx->flt_tbl[i][ip];
 		if (ipa_flt_skip_pipe_config(i)) {
+			/* someone else owns the header, forget ours */
+			tbl->hdr_valid = false;
+			hdr_idx++;
+			continue;
+		}
+
+		if (ipa_flt_hdr_unchanged(tbl, &alloc_params, hdr_idx)) {
+			IPADBG_LOW("skip hdr at index %d for pipe %d\n",
+				hdr_idx, i);
+			ipa3_ctx->stats.flt_cmt[ip].hdr_skipped++;
 			hdr_idx++;
 			continue;
 		}
@@ -850,6 +1029,20 @@ int __ipa_commit_flt_v3(enum ipa_ip_type ip)
 	__ipa_reap_sys_flt_tbls(ip, IPA_RULE_HASHABLE);
 	__ipa_reap_sys_flt_tbls(ip, IPA_RULE_NON_HASHABLE);
 
+	/*
+	 * all the headers written are now in the sram. tables stay dirty
+	 * until here so that a failed commit is retried in full
+	 */
+	for (i = 0; i < ipa3_ctx->ipa_num_pipes; i++) {
+		if (!ipa_is_ep_support_flt(i))
+			continue;
+		tbl = &ipa3_ctx->flt_tbl[i][ip];
+		tbl->dirty = false;
+		if (!ipa_flt_skip_pipe_config(i))
+			tbl->hdr_valid = true;
+	}
+	ipa3_fltrt_cmt_lat(&ipa3_ctx->stats.flt_cmt[ip], start);
+
 fail_imm_cmd_construct:
 	for (i = 0 ; i < num_cmd ; i++)
 		ipahal_destroy_imm_cmd(cmd_pyld[i]);
@@ -868,6 +1061,81 @@ prep_failed:
 	return rc;
 }
 
+/**
+ * ipa3_flt_invalidate_tbls() - have the next commit regenerate and write
+ *  all flt tbls
+ * @ip: the ip address family type
+ *
+ * For when what the tables were generated from changed under them, or
+ * when their headers in the sram may have been overwritten.
+ *
+ * caller needs to hold any needed locks to ensure integrity
+ */
+void ipa3_flt_invalidate_tbls(enum ipa_ip_type ip)
+{
+	struct ipa3_flt_tbl *tbl;
+	int i;
+
+	for (i = 0; i < ipa3_ctx->ipa_num_pipes; i++) {
+		if (!ipa_is_ep_support_flt(i))
+			continue;
+		tbl = &ipa3_ctx->flt_tbl[i][ip];
+		ipa3_flt_tbl_set_dirty(tbl);
+		tbl->hdr_valid = false;
+	}
+}
+
+/**
+ * ipa3_flt_verify_tbl_bodies() - check the system memory bodies kept by
+ *  the commit against freshly generated ones
+ * @ip: the ip address family type
+ *
+ * Every body the next commit would reuse is generated again and compared
+ * byte for byte with the one in system memory.
+ *
+ * Return: 0 if all bodies match, negative otherwise
+ *
+ * caller needs to hold any needed locks to ensure integrity
+ */
+int ipa3_flt_verify_tbl_bodies(enum ipa_ip_type ip)
+{
+	struct ipa3_flt_tbl *tbl;
+	enum ipa_rule_type rlt;
+	u32 hdr_width;
+	u8 *buf;
+	int rc = 0;
+	int i;
+
+	hdr_width = ipahal_get_hw_tbl_hdr_width();
+	for (i = 0; i < ipa3_ctx->ipa_num_pipes; i++) {
+		if (!ipa_is_ep_support_flt(i))
+			continue;
+		tbl = &ipa3_ctx->flt_tbl[i][ip];
+		if (tbl->dirty)
+			continue;
+		for (rlt = IPA_RULE_HASHABLE; rlt < IPA_RULE_TYPE_MAX; rlt++) {
+			if (!tbl->sz[rlt] || !tbl->body_valid[rlt] ||
+				!tbl->curr_mem[rlt].phys_base)
+				continue;
+
+			buf = kzalloc(tbl->curr_mem[rlt].size, GFP_KERNEL);
+			if (!buf)
+				return -ENOMEM;
+
+			if (ipa_generate_flt_tbl_body(ip, tbl, rlt, buf) ||
+				memcmp(buf, tbl->curr_mem[rlt].base,
+					tbl->sz[rlt] - hdr_width)) {
+				IPAERR("flt tbl pipe=%d ip=%d rlt=%d body mismatch\n",
+					i, ip, rlt);
+				rc = -EFAULT;
+			}
+			kfree(buf);
+		}
+	}
+
+	return rc;
+}
+
 static int __ipa_validate_flt_rule(const struct ipa_flt_rule_i *rule,
 		struct ipa3_rt_tbl **rt_tbl, enum ipa_ip_type ip)
 {
@@ -1019,6 +1287,7 @@ static int __ipa_finish_flt_rule_add(struct ipa3_flt_tbl *tbl,
 	}
 	*rule_hdl = id;
 	entry->id = id;
+	ipa3_flt_tbl_set_dirty(tbl);
 	IPADBG_LOW("add flt rule rule_cnt=%d\n", tbl->rule_cnt);
 
 	return 0;
@@ -1136,6 +1405,7 @@ static int __ipa_del_flt_rule(u32 rule_hdl)
 
 	list_del(&entry->link);
 	entry->tbl->rule_cnt--;
+	ipa3_flt_tbl_set_dirty(entry->tbl);
 	if (entry->rt_tbl && !ipa3_check_idr_if_freed(entry->rt_tbl))
 		entry->rt_tbl->ref_cnt--;
 	IPADBG("del flt rule rule_cnt=%d rule_id=%d\n",
@@ -1146,6 +1416,7 @@ static int __ipa_del_flt_rule(u32 rule_hdl)
 		(entry->rule_id >= ipahal_get_low_rule_id()))
 		idr_remove(entry->tbl->rule_ids, entry->rule_id);
 
+	ipa3_flt_drop_hw_rule(entry);
 	kmem_cache_free(ipa3_ctx->flt_rule_cache, entry);
 
 	/* remove the handle from the database */
@@ -1178,11 +1449,13 @@ static int __ipa_mdfy_flt_rule(struct ipa_flt_rule_mdfy_i *frule,
 		entry->rt_tbl->ref_cnt--;
 
 	entry->rule = frule->rule;
+	ipa3_flt_drop_hw_rule(entry);
 	entry->rt_tbl = rt_tbl;
 	if (entry->rt_tbl)
 		entry->rt_tbl->ref_cnt++;
 	entry->hw_len = 0;
 	entry->prio = 0;
+	ipa3_flt_tbl_set_dirty(entry->tbl);
 	if (frule->rule.enable_stats)
 		entry->cnt_idx = frule->rule.cnt_idx;
 	else
@@ -1927,6 +2200,7 @@ int ipa3_reset_flt(enum ipa_ip_type ip, bool user_only)
 					idr_remove(entry->tbl->rule_ids,
 						rule_id);
 				entry->cookie = 0;
+				ipa3_flt_drop_hw_rule(entry);
 				kmem_cache_free(ipa3_ctx->flt_rule_cache,
 								entry);
 
@@ -1935,6 +2209,7 @@ int ipa3_reset_flt(enum ipa_ip_type ip, bool user_only)
 			}
 		}
 	}
+	ipa3_flt_invalidate_tbls(ip);
 
 	/* commit the change to IPA-HW */
 	if (ipa3_ctx->ctrl->ipa3_commit_flt(IPA_IP_v4) ||
@@ -2253,6 +2528,8 @@ int ipa_flt_sram_set_client_prio_high(enum ipa_client_type client)
 				break;
 			}
 		}
+		/* the tables placed in sram may change */
+		ipa3_flt_invalidate_tbls(ip);
 	}
 	mutex_unlock(&ipa3_ctx->lock);
 
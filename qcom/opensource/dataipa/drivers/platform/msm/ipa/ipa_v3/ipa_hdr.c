@@ -559,16 +559,48 @@ bad_len:
 	return -EPERM;
 }
 
+/**
+ * __ipa_find_hdr() - find a header entry by name
+ * @name: name of the header entry
+ *
+ * The SRAM table is searched before the DDR one. Entries are indexed by name
+ * in the same order they are linked in head_hdr_entry_list, so the entry
+ * found is the same one a walk of the lists would return.
+ *
+ * Returns: the header entry, or NULL if it doesn't exist
+ */
+static struct ipa3_hdr_entry *__ipa_find_hdr(const char *name)
+{
+	struct ipa3_hdr_entry *entry;
+	enum hdr_tbl_storage hdr_tbl_loc;
+	u32 key;
+
+	if (strnlen(name, IPA_RESOURCE_NAME_MAX) == IPA_RESOURCE_NAME_MAX) {
+		IPAERR_RL("Header name too long: %s\n", name);
+		return NULL;
+	}
+
+	key = ipa3_name_hash(name);
+	for (hdr_tbl_loc = HDR_TBL_LCL; hdr_tbl_loc < HDR_TBLS_TOTAL; hdr_tbl_loc++) {
+		hash_for_each_possible(ipa3_ctx->hdr_tbl[hdr_tbl_loc].name_ht,
+				       entry, name_node, key) {
+			if (!strcmp(name, entry->name))
+				return entry;
+		}
+	}
+
+	return NULL;
+}
+
 static int __ipa_add_hdr(struct ipa_hdr_add *hdr, bool user,
 	struct ipa3_hdr_entry **entry_out)
 {
-	struct ipa3_hdr_entry *entry, *entry_t, *next;
+	struct ipa3_hdr_entry *entry, *entry_t;
 	struct ipa_hdr_offset_entry *offset = NULL;
 	u32 bin;
 	struct ipa3_hdr_tbl *htbl;
 	int id;
 	int mem_size;
-	enum hdr_tbl_storage hdr_tbl_loc;
 
 	if (hdr->hdr_len > IPA_HDR_MAX_SIZE) {
 		IPAERR_RL("bad param\n");
@@ -600,23 +632,18 @@ static int __ipa_add_hdr(struct ipa_hdr_add *hdr, bool user,
 			 !IPA_MEM_PART(apps_hdr_size)) ? false : true;
 
 	/* check to see if adding header entry with duplicate name */
-	for (hdr_tbl_loc = HDR_TBL_LCL; hdr_tbl_loc < HDR_TBLS_TOTAL; hdr_tbl_loc++) {
-		list_for_each_entry_safe(entry_t, next,
-			&ipa3_ctx->hdr_tbl[hdr_tbl_loc].head_hdr_entry_list, link) {
+	entry_t = user ? __ipa_find_hdr(entry->name) : NULL;
+	if (entry_t) {
+		/* return if adding the same name */
+		IPAERR("IPACM Trying to add hdr %s len=%d, duplicate entry, return old one\n",
+			entry->name, entry->hdr_len);
 
-			/* return if adding the same name */
-			if (!strcmp(entry_t->name, entry->name) && (user == true)) {
-				IPAERR("IPACM Trying to add hdr %s len=%d, duplicate entry, return old one\n",
-					entry->name, entry->hdr_len);
+		/* return the original entry */
+		if (entry_out)
+			*entry_out = entry_t;
 
-				/* return the original entry */
-				if (entry_out)
-					*entry_out = entry_t;
-
-				kmem_cache_free(ipa3_ctx->hdr_cache, entry);
-				return 0;
-			}
-		}
+		kmem_cache_free(ipa3_ctx->hdr_cache, entry);
+		return 0;
 	}
 
 	if (hdr->hdr_len <= ipa_hdr_bin_sz[IPA_HDR_BIN0])
@@ -711,6 +738,7 @@ create_entry:
 free_list:
 
 	list_add(&entry->link, &htbl->head_hdr_entry_list);
+	hash_add(htbl->name_ht, &entry->name_node, ipa3_name_hash(entry->name));
 	htbl->hdr_cnt++;
 	IPADBG("add hdr of sz=%d hdr_cnt=%d ofst=%d to %s table\n",
 			hdr->hdr_len,
@@ -739,6 +767,7 @@ ipa_insert_failed:
 	entry->offset_entry = NULL;
 	htbl->hdr_cnt--;
 	list_del(&entry->link);
+	hash_del(&entry->name_node);
 
 bad_hdr_len:
 	entry->cookie = 0;
@@ -873,6 +902,7 @@ int __ipa3_del_hdr(u32 hdr_hdl, bool by_user)
 		list_move(&entry->offset_entry->link,
 			&htbl->head_free_offset_list[entry->offset_entry->bin]);
 	list_del(&entry->link);
+	hash_del(&entry->name_node);
 	htbl->hdr_cnt--;
 	entry->cookie = 0;
 	kmem_cache_free(ipa3_ctx->hdr_cache, entry);
@@ -1334,6 +1364,7 @@ int ipa3_reset_hdr(bool user_only)
 
 				/* delete the hdr entry from headers list */
 				list_del(&entry->link);
+				hash_del(&entry->name_node);
 				ipa3_ctx->hdr_tbl[hdr_tbl_loc].hdr_cnt--;
 				entry->ref_cnt = 0;
 				entry->cookie = 0;
@@ -1427,6 +1458,10 @@ int ipa3_reset_hdr(bool user_only)
 		htbl_proc->proc_ctx_cnt = 0;
 	}
 
+	/* routing rules left in place may point to the removed headers */
+	ipa3_rt_invalidate_tbls(IPA_IP_v4);
+	ipa3_rt_invalidate_tbls(IPA_IP_v6);
+
 	/* commit the change to IPA-HW */
 	if (ipa3_ctx->ctrl->ipa3_commit_hdr()) {
 		IPAERR("fail to commit hdr\n");
@@ -1439,27 +1474,6 @@ int ipa3_reset_hdr(bool user_only)
 	return 0;
 }
 
-static struct ipa3_hdr_entry *__ipa_find_hdr(const char *name)
-{
-	struct ipa3_hdr_entry *entry;
-	enum hdr_tbl_storage hdr_tbl_loc;
-
-	if (strnlen(name, IPA_RESOURCE_NAME_MAX) == IPA_RESOURCE_NAME_MAX) {
-		IPAERR_RL("Header name too long: %s\n", name);
-		return NULL;
-	}
-	for (hdr_tbl_loc = HDR_TBL_LCL; hdr_tbl_loc < HDR_TBLS_TOTAL; hdr_tbl_loc++) {
-		list_for_each_entry(entry,
-				    &ipa3_ctx->hdr_tbl[hdr_tbl_loc].head_hdr_entry_list,
-				    link) {
-			if (!strcmp(name, entry->name))
-				return entry;
-		}
-	}
-
-	return NULL;
-}
-
 static struct ipa3_hdr_proc_ctx_entry* __ipa_find_hdr_proc_ctx(const char *name)
 {
 	struct ipa3_hdr_entry *entry;
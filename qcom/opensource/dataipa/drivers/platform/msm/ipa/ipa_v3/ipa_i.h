@@ -11,7 +11,9 @@
 #include <linux/bitops.h>
 #include <linux/cdev.h>
 #include <linux/export.h>
+#include <linux/hashtable.h>
 #include <linux/idr.h>
+#include <linux/jhash.h>
 #include <linux/list.h>
 #include <linux/mutex.h>
 #include <linux/skbuff.h>
@@ -251,6 +253,9 @@ enum {
 #define IPA_HDR_BIN5 5
 #define IPA_HDR_BIN_MAX 6
 
+/* Buckets of the header and routing table name indexes, as a power of 2 */
+#define IPA_NAME_HASH_BITS 6
+
 enum hdr_tbl_storage {
 	HDR_TBL_LCL,
 	HDR_TBL_SYS,
@@ -762,6 +767,8 @@ struct ipa_rt_rule_add_ext_i {
  * @rule_id: rule 10bit ID to be returned in packet status
  * @cnt_idx: stats counter index
  * @ipacm_installed: indicate if installed by ipacm
+ * @hw_rule: the rule as last generated in H/W format, @hw_len long
+ * @hw_key: the generation parameters @hw_rule was generated with
  */
 struct ipa3_flt_entry {
 	struct list_head link;
@@ -775,6 +782,8 @@ struct ipa3_flt_entry {
 	u16 rule_id;
 	u8 cnt_idx;
 	bool ipacm_installed;
+	u8 *hw_rule;
+	struct ipahal_flt_rule_gen_params hw_key;
 };
 
 /**
@@ -793,9 +802,13 @@ struct ipa3_flt_entry {
  * @prev_mem: previous routing table block in sys memory
  * @id: routing table id
  * @rule_ids: common idr structure that holds the rule_id for each rule
+ * @name_node: table's node in the name index of its set
+ * @dirty: rules changed since the table was last prepared for commit
+ * @body_valid: @curr_mem holds the body of the current rules
  */
 struct ipa3_rt_tbl {
 	struct list_head link;
+	struct hlist_node name_node;
 	u32 cookie;
 	struct list_head head_rt_rule_list;
 	char name[IPA_RESOURCE_NAME_MAX];
@@ -809,6 +822,8 @@ struct ipa3_rt_tbl {
 	struct ipa_mem_buffer prev_mem[IPA_RULE_TYPE_MAX];
 	int id;
 	struct idr *rule_ids;
+	bool dirty;
+	bool body_valid[IPA_RULE_TYPE_MAX];
 };
 
 /**
@@ -829,9 +844,11 @@ struct ipa3_rt_tbl {
  * @user_deleted: is the header deleted by the user?
  * @ipacm_installed: indicate if installed by ipacm
  * @is_lcl: is the entry in the SRAM?
+ * @name_node: entry's node in the name index of its header table
  */
 struct ipa3_hdr_entry {
 	struct list_head link;
+	struct hlist_node name_node;
 	u32 cookie;
 	u8 hdr[IPA_HDR_MAX_SIZE];
 	u32 hdr_len;
@@ -856,6 +873,7 @@ struct ipa3_hdr_entry {
  * @head_free_offset_list: header free offset list
  * @hdr_cnt: number of headers
  * @end: the last header index
+ * @name_ht: index of header entries by name
  */
 struct ipa3_hdr_tbl {
 	struct list_head head_hdr_entry_list;
@@ -863,6 +881,7 @@ struct ipa3_hdr_tbl {
 	struct list_head head_free_offset_list[IPA_HDR_BIN_MAX];
 	u32 hdr_cnt;
 	u32 end;
+	DECLARE_HASHTABLE(name_ht, IPA_NAME_HASH_BITS);
 };
 
 /**
@@ -937,6 +956,10 @@ struct ipa3_hdr_proc_ctx_tbl {
  * @rule_ids: common idr structure that holds the rule_id for each rule
  * @force_sys: flag indicating if filter table is forced to be
 			located in system memory
+ * @dirty: rules changed since the table was last prepared for commit
+ * @body_valid: @curr_mem holds the body of the current rules
+ * @hdr_valid: @hdr holds what the last commit wrote to the sram header
+ * @hdr: header words of the table as last written to the sram
  */
 struct ipa3_flt_tbl {
 	struct list_head head_flt_rule_list;
@@ -948,6 +971,10 @@ struct ipa3_flt_tbl {
 	bool sticky_rear;
 	struct idr *rule_ids;
 	bool force_sys[IPA_RULE_TYPE_MAX];
+	bool dirty;
+	bool body_valid[IPA_RULE_TYPE_MAX];
+	bool hdr_valid;
+	u64 hdr[IPA_RULE_TYPE_MAX];
 };
 
 struct ipa3_flt_tbl_nhash_lcl {
@@ -971,6 +998,8 @@ struct ipa3_flt_tbl_nhash_lcl {
  * @rule_id_valid: indicate if rule_id_valid valid or not?
  * @cnt_idx: stats counter index
  * @ipacm_installed: indicate if installed by ipacm
+ * @hw_rule: the rule as last generated in H/W format, @hw_len long
+ * @hw_key: the generation parameters @hw_rule was generated with
  */
 struct ipa3_rt_entry {
 	struct list_head link;
@@ -986,6 +1015,8 @@ struct ipa3_rt_entry {
 	u16 rule_id_valid;
 	u8 cnt_idx;
 	bool ipacm_installed;
+	u8 *hw_rule;
+	struct ipahal_rt_rule_gen_params hw_key;
 };
 
 /**
@@ -993,11 +1024,15 @@ struct ipa3_rt_entry {
  * @head_rt_tbl_list: collection of routing tables
  * @tbl_cnt: number of routing tables
  * @rule_ids: idr structure that holds the rule_id for each rule
+ * @name_ht: index of the tables in @head_rt_tbl_list by name
+ * @dirty: a table was added or removed since the last commit
  */
 struct ipa3_rt_tbl_set {
 	struct list_head head_rt_tbl_list;
 	u32 tbl_cnt;
 	struct idr rule_ids;
+	DECLARE_HASHTABLE(name_ht, IPA_NAME_HASH_BITS);
+	bool dirty;
 };
 
 /**
@@ -1171,6 +1206,26 @@ struct ipa3_page_repl_ctx {
 	atomic_t pending;
 };
 
+#define IPA_TX_BATCH_BUCKETS 6
+
+/**
+ * struct ipa3_tx_batch_stats - tx submission statistics of a producer pipe
+ * @batches: ipa3_tx_dp_list() calls which queued at least one packet
+ * @pkts: packets queued by ipa3_tx_dp_list()
+ * @max_pkts: most packets queued by a single ipa3_tx_dp_list() call
+ * @doorbells: channel doorbells rung for transfers queued by ipa3_send()
+ *  and ipa3_tx_dp_list()
+ * @size: batch sizes, bucket i counts batches of less than 2^(i+1)
+ *  packets, the last one counts all the larger ones
+ */
+struct ipa3_tx_batch_stats {
+	u64 batches;
+	u64 pkts;
+	u32 max_pkts;
+	u64 doorbells;
+	u64 size[IPA_TX_BATCH_BUCKETS];
+};
+
 /**
  * struct ipa3_sys_context - IPA GPI pipes context
  * @head_desc_list: header descriptors list
@@ -1188,6 +1243,7 @@ struct ipa3_page_repl_ctx {
  * @buff_size: rx packet length
  * @page_order: page order of the rx pipe based on the ioctl version
  * @ext_ioctl_v2: specifies if it's new version of ingress/egress ioctl
+ * @tx_batch: tx submission statistics, protected by @spinlock
  *
  * IPA context specific to the GPI pipes a.k.a LAN IN/OUT and WAN
  */
@@ -1236,6 +1292,7 @@ struct ipa3_sys_context {
 	struct ipa3_sys_context *common_sys;
 	atomic_t page_avilable;
 	u32 napi_sort_page_thrshld_cnt;
+	struct ipa3_tx_batch_stats tx_batch;
 
 	/* ordering is important - mutable fields go above */
 	struct ipa3_ep_context *ep;
@@ -1567,6 +1624,7 @@ struct ipa3_page_recycle_stats {
 	u64 total_replenished;
 	u64 page_recycled;
 	u64 tmp_alloc;
+	u64 busy_rotated;
 };
 
 struct ipa3_cache_recycle_stats {
@@ -1575,6 +1633,31 @@ struct ipa3_cache_recycle_stats {
 	u64 tot_pkt_replenished;
 };
 
+#define IPA_FLTRT_CMT_LAT_BUCKETS 12
+
+/**
+ * struct ipa3_fltrt_cmt_stats - filter/routing commit statistics
+ * @commits: commits written to the hw
+ * @skipped: commits with nothing changed since the previous one
+ * @body_gen: system memory table bodies generated
+ * @body_reused: system memory table bodies reused as is
+ * @hdr_skipped: per pipe header writes skipped as unchanged (flt only)
+ * @rule_gen: rules generated in H/W format
+ * @rule_reused: rules written from the H/W format kept in their entry
+ * @lat: commit latency, bucket i counts commits which took less than
+ *  2^(i+1) usec, the last one counts all the longer ones
+ */
+struct ipa3_fltrt_cmt_stats {
+	u64 commits;
+	u64 skipped;
+	u64 body_gen;
+	u64 body_reused;
+	u64 hdr_skipped;
+	u64 rule_gen;
+	u64 rule_reused;
+	u64 lat[IPA_FLTRT_CMT_LAT_BUCKETS];
+};
+
 struct lan_coal_stats {
 	u64 coal_rx;
 	u64 coal_left_as_is;
@@ -1637,6 +1720,8 @@ struct ipa3_stats {
 	u64 num_of_times_wq_reschd;
 	u64 page_recycle_cnt_in_tasklet;
 	u32 ttl_cnt;
+	struct ipa3_fltrt_cmt_stats flt_cmt[IPA_IP_MAX];
+	struct ipa3_fltrt_cmt_stats rt_cmt[IPA_IP_MAX];
 };
 
 /* offset for each stats */
@@ -3193,6 +3278,25 @@ int ipa3_set_single_ndp_per_mbim(bool enable);
  */
 int ipa3_tx_dp(enum ipa_client_type dst, struct sk_buff *skb,
 		struct ipa_tx_meta *metadata);
+int ipa3_tx_dp_list(enum ipa_client_type dst, struct sk_buff_head *skbs,
+		struct ipa_tx_meta *metadata);
+
+/**
+ * ipa3_tx_batch_stats_inc() - account a batch queued by ipa3_tx_dp_list()
+ * @stats: the pipe tx submission statistics
+ * @pkts: number of packets queued
+ */
+static inline void ipa3_tx_batch_stats_inc(struct ipa3_tx_batch_stats *stats,
+	u32 pkts)
+{
+	int bucket = fls(pkts) - 1;
+
+	stats->batches++;
+	stats->pkts += pkts;
+	if (pkts > stats->max_pkts)
+		stats->max_pkts = pkts;
+	stats->size[min_t(int, bucket, IPA_TX_BATCH_BUCKETS - 1)]++;
+}
 
 /*
  * To transfer multiple data packets
@@ -3430,6 +3534,17 @@ int ipa3_generate_hw_rule(enum ipa_ip_type ip,
 			 u16 *en_rule);
 int ipa3_init_hw(void);
 struct ipa3_rt_tbl *__ipa3_find_rt_tbl(enum ipa_ip_type ip, const char *name);
+
+/**
+ * ipa3_name_hash() - hash a header or routing table name for its index
+ * @name: NUL terminated name, at most IPA_RESOURCE_NAME_MAX bytes long
+ *
+ * Returns: hash key of @name
+ */
+static inline u32 ipa3_name_hash(const char *name)
+{
+	return jhash(name, strnlen(name, IPA_RESOURCE_NAME_MAX), 0);
+}
 int ipa3_set_single_ndp_per_mbim(bool enable);
 void ipa3_debugfs_init(void);
 void ipa3_debugfs_remove(void);
@@ -3518,6 +3633,27 @@ int _ipa_init_flt6_v3(void);
 
 int __ipa_commit_flt_v3(enum ipa_ip_type ip);
 int __ipa_commit_rt_v3(enum ipa_ip_type ip);
+void ipa3_flt_invalidate_tbls(enum ipa_ip_type ip);
+void ipa3_rt_invalidate_tbls(enum ipa_ip_type ip);
+int ipa3_flt_verify_tbl_bodies(enum ipa_ip_type ip);
+int ipa3_rt_verify_tbl_bodies(enum ipa_ip_type ip);
+int ipa3_flt_verify_hw_rules(enum ipa_ip_type ip);
+int ipa3_rt_verify_hw_rules(enum ipa_ip_type ip);
+
+/**
+ * ipa3_fltrt_cmt_lat() - account the latency of a filter/routing commit
+ * @stats: the commit statistics to update
+ * @start: time the commit started at
+ */
+static inline void ipa3_fltrt_cmt_lat(struct ipa3_fltrt_cmt_stats *stats,
+	ktime_t start)
+{
+	s64 usec = ktime_us_delta(ktime_get(), start);
+	int bucket = usec > 0 ? fls64(usec) - 1 : 0;
+
+	stats->commits++;
+	stats->lat[min_t(int, bucket, IPA_FLTRT_CMT_LAT_BUCKETS - 1)]++;
+}
 
 int __ipa_commit_hdr_v3_0(void);
 void ipa3_skb_recycle(struct sk_buff *skb);
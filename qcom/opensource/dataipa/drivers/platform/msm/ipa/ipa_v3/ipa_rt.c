@@ -23,6 +23,24 @@
 	(IPA_RULE_HASHABLE) : (IPA_RULE_NON_HASHABLE) \
 	)
 
+/*
+ * mark a table as changed so the next commit prepares it again and
+ * regenerates its system memory bodies
+ */
+static void ipa3_rt_tbl_set_dirty(struct ipa3_rt_tbl *tbl)
+{
+	tbl->dirty = true;
+	tbl->body_valid[IPA_RULE_HASHABLE] = false;
+	tbl->body_valid[IPA_RULE_NON_HASHABLE] = false;
+}
+
+/* forget the H/W format kept for the entry, its rule changed or it goes */
+static void ipa3_rt_drop_hw_rule(struct ipa3_rt_entry *entry)
+{
+	kfree(entry->hw_rule);
+	entry->hw_rule = NULL;
+}
+
 /**
  * ipa_generate_rt_hw_rule() - Generated the RT H/W single rule
  *  This func will do the preparation core driver work and then calls
@@ -48,6 +66,7 @@ static int ipa_generate_rt_hw_rule(enum ipa_ip_type ip,
 	struct ipahal_rt_rule_gen_params gen_params;
 	struct ipa3_hdr_entry *hdr_entry;
 	struct ipa3_hdr_proc_ctx_entry *hdr_proc_entry;
+	u8 *scratch = NULL;
 	int res = 0;
 
 	memset(&gen_params, 0, sizeof(gen_params));
@@ -126,13 +145,106 @@ static int ipa_generate_rt_hw_rule(enum ipa_ip_type ip,
 	gen_params.rule = (const struct ipa_rt_rule_i *)&entry->rule;
 	gen_params.cnt_idx = entry->cnt_idx;
 
-	res = ipahal_rt_generate_hw_rule(&gen_params, &entry->hw_len, buf);
-	if (res)
+	if (entry->hw_rule &&
+		!memcmp(&entry->hw_key, &gen_params, sizeof(gen_params))) {
+		ipa3_ctx->stats.rt_cmt[ip].rule_reused++;
+		if (!buf)
+			return 0;
+		return ipahal_fltrt_write_hw_rule(entry->hw_rule,
+			entry->hw_len, buf);
+	}
+
+	ipa3_rt_drop_hw_rule(entry);
+	if (!buf) {
+		scratch = kzalloc(ipahal_get_hw_rule_buf_size(), GFP_KERNEL);
+		if (!scratch)
+			return -ENOMEM;
+	}
+
+	res = ipahal_rt_generate_hw_rule(&gen_params, &entry->hw_len,
+		buf ? buf : scratch);
+	if (res) {
 		IPAERR("failed to generate rt h/w rule\n");
+	} else {
+		ipa3_ctx->stats.rt_cmt[ip].rule_gen++;
+		/* keeping the rule is best effort, it is regenerated if absent */
+		entry->hw_rule = kmemdup(buf ? buf : scratch, entry->hw_len,
+			GFP_KERNEL);
+		if (entry->hw_rule)
+			memcpy(&entry->hw_key, &gen_params, sizeof(gen_params));
+	}
 
+	kfree(scratch);
 	return res;
 }
 
+/**
+ * ipa3_rt_verify_hw_rules() - check the H/W format rules kept by the
+ *  routing entries against freshly generated ones
+ * @ip: the ip address family type
+ *
+ * Return: 0 if all kept rules match, negative otherwise
+ *
+ * caller needs to hold any needed locks to ensure integrity
+ */
+int ipa3_rt_verify_hw_rules(enum ipa_ip_type ip)
+{
+	struct ipa3_rt_tbl *tbl;
+	struct ipa3_rt_entry *entry;
+	u32 hw_len;
+	u8 *buf;
+	int rc = 0;
+
+	buf = kzalloc(ipahal_get_hw_rule_buf_size(), GFP_KERNEL);
+	if (!buf)
+		return -ENOMEM;
+
+	list_for_each_entry(tbl, &ipa3_ctx->rt_tbl_set[ip].head_rt_tbl_list,
+		link) {
+		list_for_each_entry(entry, &tbl->head_rt_rule_list, link) {
+			if (!entry->hw_rule)
+				continue;
+			if (ipahal_rt_generate_hw_rule(&entry->hw_key, &hw_len,
+				buf) || hw_len != entry->hw_len ||
+				memcmp(buf, entry->hw_rule, hw_len)) {
+				IPAERR("rt rule %d tbl %s ip=%d mismatch\n",
+					entry->rule_id, tbl->name, ip);
+				rc = -EFAULT;
+			}
+		}
+	}
+
+	kfree(buf);
+	return rc;
+}
+
+/**
+ * ipa_generate_rt_tbl_body() - generate the rules of a table into a buffer
+ * @ip: the ip address family type
+ * @tbl: the rt tbl to generate
+ * @rlt: the type of the rules to generate (hashable or non-hashable)
+ * @buf: the buffer to be filled, sized per the last prepare of the table
+ *
+ * Returns: 0 on success, negative on failure
+ */
+static int ipa_generate_rt_tbl_body(enum ipa_ip_type ip,
+	struct ipa3_rt_tbl *tbl, enum ipa_rule_type rlt, u8 *buf)
+{
+	struct ipa3_rt_entry *entry;
+
+	list_for_each_entry(entry, &tbl->head_rt_rule_list, link) {
+		if (IPA_RT_GET_RULE_TYPE(entry) != rlt)
+			continue;
+		if (ipa_generate_rt_hw_rule(ip, entry, buf)) {
+			IPAERR_RL("failed to gen HW RT rule\n");
+			return -EPERM;
+		}
+		buf += entry->hw_len;
+	}
+
+	return 0;
+}
+
 /**
  * ipa_translate_rt_tbl_to_hw_fmt() - translate the routing driver structures
  *  (rules and tables) to HW format and fill it in the given buffers
@@ -144,6 +256,9 @@ static int ipa_generate_rt_hw_rule(enum ipa_ip_type ip,
  *  ipa sram (for local body usage)
  * @apps_start_idx: the first rt table index of apps tables
  *
+ * System memory bodies of tables which did not change since they were
+ * generated are kept and only their address is written to the header.
+ *
  * Returns: 0 on success, negative on failure
  *
  * caller needs to hold any needed locks to ensure integrity
@@ -156,7 +271,6 @@ static int ipa_translate_rt_tbl_to_hw_fmt(enum ipa_ip_type ip,
 	struct ipa3_rt_tbl_set *set;
 	struct ipa3_rt_tbl *tbl;
 	struct ipa_mem_buffer tbl_mem;
-	u8 *tbl_mem_buf;
 	struct ipa3_rt_entry *entry;
 	int res;
 	u64 offset;
@@ -167,7 +281,16 @@ static int ipa_translate_rt_tbl_to_hw_fmt(enum ipa_ip_type ip,
 	list_for_each_entry(tbl, &set->head_rt_tbl_list, link) {
 		if (tbl->sz[rlt] == 0)
 			continue;
-		if (tbl->in_sys[rlt]) {
+		if (tbl->in_sys[rlt] && tbl->body_valid[rlt] &&
+			tbl->curr_mem[rlt].phys_base) {
+			if (ipahal_fltrt_write_addr_to_hdr(
+				tbl->curr_mem[rlt].phys_base, hdr,
+				tbl->idx - apps_start_idx, true)) {
+				IPAERR_RL("fail to wrt sys tbl addr to hdr\n");
+				goto err;
+			}
+			ipa3_ctx->stats.rt_cmt[ip].body_reused++;
+		} else if (tbl->in_sys[rlt]) {
 			/* only body (no header) */
 			tbl_mem.size = tbl->sz[rlt] -
 				ipahal_get_hw_tbl_hdr_width();
@@ -186,27 +309,18 @@ static int ipa_translate_rt_tbl_to_hw_fmt(enum ipa_ip_type ip,
 				goto hdr_update_fail;
 			}
 
-			tbl_mem_buf = tbl_mem.base;
-
 			/* generate the rule-set */
-			list_for_each_entry(entry, &tbl->head_rt_rule_list,
-					link) {
-				if (IPA_RT_GET_RULE_TYPE(entry) != rlt)
-					continue;
-				res = ipa_generate_rt_hw_rule(ip, entry,
-					tbl_mem_buf);
-				if (res) {
-					IPAERR_RL("failed to gen HW RT rule\n");
-					goto hdr_update_fail;
-				}
-				tbl_mem_buf += entry->hw_len;
-			}
+			if (ipa_generate_rt_tbl_body(ip, tbl, rlt,
+				tbl_mem.base))
+				goto hdr_update_fail;
 
 			if (tbl->curr_mem[rlt].phys_base) {
 				WARN_ON(tbl->prev_mem[rlt].phys_base);
 				tbl->prev_mem[rlt] = tbl->curr_mem[rlt];
 			}
 			tbl->curr_mem[rlt] = tbl_mem;
+			tbl->body_valid[rlt] = true;
+			ipa3_ctx->stats.rt_cmt[ip].body_gen++;
 		} else {
 			offset = body_i - base + body_ofst;
 
@@ -294,6 +408,9 @@ static void __ipa_reap_sys_rt_tbls(enum ipa_ip_type ip)
  * @ip: the ip address family type
  * @tbl: the rt tbl to be prepared
  *
+ * Tables which did not change since they were last committed keep their
+ * priorities and sizes.
+ *
  * Return: 0 on success, negative on failure
  */
 static int ipa_prep_rt_tbl_for_cmt(enum ipa_ip_type ip,
@@ -305,6 +422,9 @@ static int ipa_prep_rt_tbl_for_cmt(enum ipa_ip_type ip,
 	int max_prio;
 	u32 hdr_width;
 
+	if (!tbl->dirty)
+		return 0;
+
 	tbl->sz[IPA_RULE_HASHABLE] = 0;
 	tbl->sz[IPA_RULE_NON_HASHABLE] = 0;
 
@@ -459,6 +579,8 @@ static bool ipa_rt_valid_lcl_tbl_size(enum ipa_ip_type ipt,
  * commit the headers and the bodies if are local with internal cache flushing
  * @ipt: the ip address family type
  *
+ * Nothing is written when no table changed since the previous commit.
+ *
  * Return: 0 on success, negative on failure
  */
 int __ipa_commit_rt_v3(enum ipa_ip_type ip)
@@ -481,6 +603,8 @@ int __ipa_commit_rt_v3(enum ipa_ip_type ip)
 	struct ipa3_rt_tbl *tbl;
 	u32 tbl_hdr_width;
 	struct ipahal_imm_cmd_register_write reg_write_coal_close;
+	ktime_t start = ktime_get();
+	bool changed;
 
 	tbl_hdr_width = ipahal_get_hw_tbl_hdr_width();
 	memset(desc, 0, sizeof(desc));
@@ -533,7 +657,9 @@ int __ipa_commit_rt_v3(enum ipa_ip_type ip)
 	}
 
 	set = &ipa3_ctx->rt_tbl_set[ip];
+	changed = set->dirty;
 	list_for_each_entry(tbl, &set->head_rt_tbl_list, link) {
+		changed |= tbl->dirty;
 		if (ipa_prep_rt_tbl_for_cmt(ip, tbl)) {
 			rc = -EPERM;
 			goto no_rt_tbls;
@@ -554,6 +680,12 @@ int __ipa_commit_rt_v3(enum ipa_ip_type ip)
 		}
 	}
 
+	if (!changed) {
+		IPADBG_LOW("no rt tbl changed, skip commit. IP %d\n", ip);
+		ipa3_ctx->stats.rt_cmt[ip].skipped++;
+		goto no_rt_tbls;
+	}
+
 	if (ipa_generate_rt_hw_tbl_img(ip, &alloc_params)) {
 		IPAERR("fail to generate RT HW TBL images. IP %d\n", ip);
 		rc = -EFAULT;
@@ -759,6 +891,11 @@ int __ipa_commit_rt_v3(enum ipa_ip_type ip)
 	}
 
 	__ipa_reap_sys_rt_tbls(ip);
+	/* tables stay dirty until here so that a failed commit is retried */
+	list_for_each_entry(tbl, &set->head_rt_tbl_list, link)
+		tbl->dirty = false;
+	set->dirty = false;
+	ipa3_fltrt_cmt_lat(&ipa3_ctx->stats.rt_cmt[ip], start);
 
 fail_imm_cmd_construct:
 	for (i = 0 ; i < num_cmd ; i++)
@@ -776,12 +913,83 @@ no_rt_tbls:
 	return rc;
 }
 
+/**
+ * ipa3_rt_invalidate_tbls() - have the next commit regenerate all rt tbls
+ * @ip: the ip address family type
+ *
+ * For when what the tables were generated from changed under them, e.g.
+ * the headers their rules point to were reset.
+ *
+ * caller needs to hold any needed locks to ensure integrity
+ */
+void ipa3_rt_invalidate_tbls(enum ipa_ip_type ip)
+{
+	struct ipa3_rt_tbl_set *set = &ipa3_ctx->rt_tbl_set[ip];
+	struct ipa3_rt_tbl *tbl;
+
+	list_for_each_entry(tbl, &set->head_rt_tbl_list, link)
+		ipa3_rt_tbl_set_dirty(tbl);
+	set->dirty = true;
+}
+
+/**
+ * ipa3_rt_verify_tbl_bodies() - check the system memory bodies kept by
+ *  the commit against freshly generated ones
+ * @ip: the ip address family type
+ *
+ * Every body the next commit would reuse is generated again and compared
+ * byte for byte with the one in system memory.
+ *
+ * Return: 0 if all bodies match, negative otherwise
+ *
+ * caller needs to hold any needed locks to ensure integrity
+ */
+int ipa3_rt_verify_tbl_bodies(enum ipa_ip_type ip)
+{
+	struct ipa3_rt_tbl *tbl;
+	enum ipa_rule_type rlt;
+	u32 hdr_width;
+	u8 *buf;
+	int rc = 0;
+
+	hdr_width = ipahal_get_hw_tbl_hdr_width();
+	list_for_each_entry(tbl, &ipa3_ctx->rt_tbl_set[ip].head_rt_tbl_list,
+		link) {
+		if (tbl->dirty)
+			continue;
+		for (rlt = IPA_RULE_HASHABLE; rlt < IPA_RULE_TYPE_MAX; rlt++) {
+			if (!tbl->sz[rlt] || !tbl->body_valid[rlt] ||
+				!tbl->curr_mem[rlt].phys_base)
+				continue;
+
+			buf = kzalloc(tbl->curr_mem[rlt].size, GFP_KERNEL);
+			if (!buf)
+				return -ENOMEM;
+
+			if (ipa_generate_rt_tbl_body(ip, tbl, rlt, buf) ||
+				memcmp(buf, tbl->curr_mem[rlt].base,
+					tbl->sz[rlt] - hdr_width)) {
+				IPAERR("rt tbl %s ip=%d rlt=%d body mismatch\n",
+					tbl->name, ip, rlt);
+				rc = -EFAULT;
+			}
+			kfree(buf);
+		}
+	}
+
+	return rc;
+}
+
 /**
  * __ipa3_find_rt_tbl() - find the routing table
  *			which name is given as parameter
  * @ip:	[in] the ip address family type of the wanted routing table
  * @name:	[in] the name of the wanted routing table
  *
+ * The tables of a set are indexed by name in the same order they are linked
+ * in head_rt_tbl_list, so the table found is the one a walk of the list
+ * would return.
+ *
  * Returns: the routing table which name is given as parameter, or NULL if it
  * doesn't exist
  */
@@ -796,7 +1004,8 @@ struct ipa3_rt_tbl *__ipa3_find_rt_tbl(enum ipa_ip_type ip, const char *name)
 	}
 
 	set = &ipa3_ctx->rt_tbl_set[ip];
-	list_for_each_entry(entry, &set->head_rt_tbl_list, link) {
+	hash_for_each_possible(set->name_ht, entry, name_node,
+			       ipa3_name_hash(name)) {
 		if (!ipa3_check_idr_if_freed(entry) &&
 			!strcmp(name, entry->name))
 			return entry;
@@ -897,6 +1106,10 @@ static struct ipa3_rt_tbl *__ipa_add_rt_tbl(enum ipa_ip_type ip,
 		set->tbl_cnt++;
 		entry->rule_ids = &set->rule_ids;
 		list_add(&entry->link, &set->head_rt_tbl_list);
+		hash_add(set->name_ht, &entry->name_node,
+			 ipa3_name_hash(entry->name));
+		ipa3_rt_tbl_set_dirty(entry);
+		set->dirty = true;
 
 		IPADBG("add rt tbl idx=%d tbl_cnt=%d ip=%d\n", entry->idx,
 				set->tbl_cnt, ip);
@@ -914,6 +1127,7 @@ static struct ipa3_rt_tbl *__ipa_add_rt_tbl(enum ipa_ip_type ip,
 ipa_insert_failed:
 	set->tbl_cnt--;
 	list_del(&entry->link);
+	hash_del(&entry->name_node);
 	idr_destroy(entry->rule_ids);
 fail_rt_idx_alloc:
 	entry->cookie = 0;
@@ -950,6 +1164,9 @@ static int __ipa_del_rt_tbl(struct ipa3_rt_tbl *entry)
 	rset = &ipa3_ctx->reap_rt_tbl_set[ip];
 
 	entry->rule_ids = NULL;
+	entry->set->dirty = true;
+	/* the reap set is never looked up by name */
+	hash_del(&entry->name_node);
 	if (entry->in_sys[IPA_RULE_HASHABLE] ||
 		entry->in_sys[IPA_RULE_NON_HASHABLE]) {
 		list_move(&entry->link, &rset->head_rt_tbl_list);
@@ -1125,6 +1342,7 @@ static int __ipa_finish_rt_rule_add(struct ipa3_rt_entry *entry, u32 *rule_hdl,
 		tbl->idx, tbl->rule_cnt, entry->rule_id);
 	*rule_hdl = id;
 	entry->id = id;
+	ipa3_rt_tbl_set_dirty(tbl);
 
 	return 0;
 
@@ -1815,6 +2033,7 @@ int __ipa3_del_rt_rule(u32 rule_hdl)
 		__ipa3_release_hdr_proc_ctx(entry->proc_ctx->id);
 	list_del(&entry->link);
 	entry->tbl->rule_cnt--;
+	ipa3_rt_tbl_set_dirty(entry->tbl);
 	IPADBG("del rt rule tbl_idx=%d rule_cnt=%d rule_id=%d\n ref_cnt=%u",
 		entry->tbl->idx, entry->tbl->rule_cnt,
 		entry->rule_id, entry->tbl->ref_cnt);
@@ -1827,6 +2046,7 @@ int __ipa3_del_rt_rule(u32 rule_hdl)
 	}
 	entry->cookie = 0;
 	id = entry->id;
+	ipa3_rt_drop_hw_rule(entry);
 	kmem_cache_free(ipa3_ctx->rt_rule_cache, entry);
 
 	/* remove the handle from the database */
@@ -2022,6 +2242,7 @@ int ipa3_reset_rt(enum ipa_ip_type ip, bool user_only)
 					idr_remove(tbl->rule_ids,
 						rule->rule_id);
 				id = rule->id;
+				ipa3_rt_drop_hw_rule(rule);
 				kmem_cache_free(ipa3_ctx->rt_rule_cache, rule);
 
 				/* remove the handle from the database */
@@ -2040,6 +2261,7 @@ int ipa3_reset_rt(enum ipa_ip_type ip, bool user_only)
 		if (tbl->idx != apps_start_idx) {
 			if (!user_only || tbl_user) {
 				tbl->rule_ids = NULL;
+				hash_del(&tbl->name_node);
 				if (tbl->in_sys[IPA_RULE_HASHABLE] ||
 					tbl->in_sys[IPA_RULE_NON_HASHABLE]) {
 					list_move(&tbl->link,
@@ -2065,6 +2287,13 @@ int ipa3_reset_rt(enum ipa_ip_type ip, bool user_only)
 		}
 	}
 
+	/*
+	 * filtering rules left in place may point to the removed tables,
+	 * have both regenerated in full
+	 */
+	ipa3_rt_invalidate_tbls(ip);
+	ipa3_flt_invalidate_tbls(ip);
+
 	/* commit the change to IPA-HW */
 	if (ipa3_ctx->ctrl->ipa3_commit_rt(IPA_IP_v4) ||
 		ipa3_ctx->ctrl->ipa3_commit_rt(IPA_IP_v6)) {
@@ -2234,6 +2463,7 @@ static int __ipa_mdfy_rt_rule(struct ipa_rt_rule_mdfy_i *rtrule)
 		entry->proc_ctx->ref_cnt--;
 
 	entry->rule = rtrule->rule;
+	ipa3_rt_drop_hw_rule(entry);
 	entry->hdr = hdr;
 	entry->proc_ctx = proc_ctx;
 
@@ -2244,6 +2474,7 @@ static int __ipa_mdfy_rt_rule(struct ipa_rt_rule_mdfy_i *rtrule)
 
 	entry->hw_len = 0;
 	entry->prio = 0;
+	ipa3_rt_tbl_set_dirty(entry->tbl);
 	if (rtrule->rule.enable_stats)
 		entry->cnt_idx = rtrule->rule.cnt_idx;
 	else
@@ -4785,6 +4785,47 @@ u32 ipahal_get_hw_prefetch_buf_size(void)
 	return ipahal_fltrt_objs[ipahal_ctx->hw_type].prefetech_buf_size;
 }
 
+/* Get the buffer size a single generated H/W rule may need, including
+ * the rule-set terminator written after it
+ */
+u32 ipahal_get_hw_rule_buf_size(void)
+{
+	struct ipahal_fltrt_obj *obj = &ipahal_fltrt_objs[ipahal_ctx->hw_type];
+
+	return obj->rule_buf_size + obj->tbl_width;
+}
+
+/*
+ * ipahal_fltrt_write_hw_rule() - write a previously generated H/W rule
+ *  into a table buffer, followed by the rule-set terminator, the same way
+ *  ipahal_rt/flt_generate_hw_rule() would
+ * @rule: the rule in H/W format
+ * @hw_len: size of @rule
+ * @buf: rule start aligned buffer to write the rule into
+ */
+int ipahal_fltrt_write_hw_rule(const u8 *rule, u32 hw_len, u8 *buf)
+{
+	struct ipahal_fltrt_obj *obj;
+
+	if (!rule || !buf) {
+		IPAHAL_ERR("Input err: rule=%pK buf=%pK\n", rule, buf);
+		return -EINVAL;
+	}
+
+	obj = &ipahal_fltrt_objs[ipahal_ctx->hw_type];
+
+	if ((long)buf & obj->rule_start_alignment) {
+		IPAHAL_ERR("buff is not rule rule start aligned\n");
+		return -EPERM;
+	}
+
+	memcpy(buf, rule, hw_len);
+	/* write the rule-set terminator */
+	memset(buf + hw_len, 0, obj->tbl_width);
+
+	return 0;
+}
+
 /*
  * Rule priority is used to distinguish rules order
  * at the integrated table consisting from hashable and
@@ -152,6 +152,21 @@ u32 ipahal_get_lcl_tbl_addr_alignment(void);
 /* Get the H/W (flt/rt) prefetch buf size */
 u32 ipahal_get_hw_prefetch_buf_size(void);
 
+/* Get the buffer size a single generated H/W rule may need, including
+ * the rule-set terminator written after it
+ */
+u32 ipahal_get_hw_rule_buf_size(void);
+
+/*
+ * ipahal_fltrt_write_hw_rule() - write a previously generated H/W rule
+ *  into a table buffer, followed by the rule-set terminator, the same way
+ *  ipahal_rt/flt_generate_hw_rule() would
+ * @rule: the rule in H/W format
+ * @hw_len: size of @rule
+ * @buf: rule start aligned buffer to write the rule into
+ */
+int ipahal_fltrt_write_hw_rule(const u8 *rule, u32 hw_len, u8 *buf);
+
 /*
  * Rule priority is used to distinguish rules order
  * at the integrated table consisting from hashable and
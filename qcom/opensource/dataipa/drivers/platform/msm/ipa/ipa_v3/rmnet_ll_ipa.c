@@ -80,6 +80,7 @@ struct rmnet_ll_ipa3_context {
 	atomic_t under_flow_controlled_state;
 	u32 free_credit_thrshld;
 	struct sk_buff_head tx_queue;
+	bool tx_draining;
 	u32 rmnet_ll_pm_hdl;
 	struct rmnet_ll_ipa3_debugfs dbgfs;
 	struct mutex lock;
@@ -672,8 +673,12 @@ int ipa3_rmnet_ll_xmit(struct sk_buff *skb)
 		return -EAGAIN;
 	}
 
-	/* if queue is not empty, means we still have pending wq */
-	if (skb_queue_len(&rmnet_ll_ipa3_ctx->tx_queue) != 0) {
+	/*
+	 * if queue is not empty, means we still have pending wq; while the
+	 * wq sends a batch, queue behind it so packets stay in order
+	 */
+	if (skb_queue_len(&rmnet_ll_ipa3_ctx->tx_queue) != 0 ||
+		rmnet_ll_ipa3_ctx->tx_draining) {
 		skb_queue_tail(&rmnet_ll_ipa3_ctx->tx_queue, skb);
 		free_desc = (RMNET_LL_QUEUE_MAX - (atomic_read(
 		&rmnet_ll_ipa3_ctx->stats.outstanding_pkts)+
@@ -761,8 +766,9 @@ static void rmnet_ll_wakeup_ipa(struct work_struct *work)
 {
 	int ret;
 	unsigned long flags;
+	struct sk_buff_head batch;
 	struct sk_buff *skb;
-	int len = 0;
+	u32 pkts, len, left_len;
 
 	/* calling from WQ */
 	ret = ipa_pm_activate_sync(rmnet_ll_ipa3_ctx->rmnet_ll_pm_hdl);
@@ -775,42 +781,62 @@ static void rmnet_ll_wakeup_ipa(struct work_struct *work)
 		return;
 	}
 
+	skb_queue_head_init(&batch);
 	spin_lock_irqsave(&rmnet_ll_ipa3_ctx->tx_lock, flags);
-	/* dequeue the skb */
+	/*
+	 * Take the whole queue and hand it to IPA in one call, so that the
+	 * channel doorbell is rung once per batch. tx_draining keeps
+	 * ipa3_rmnet_ll_xmit() queueing behind the batch meanwhile.
+	 */
 	while (skb_queue_len(&rmnet_ll_ipa3_ctx->tx_queue) > 0) {
-		skb = skb_dequeue(&rmnet_ll_ipa3_ctx->tx_queue);
-		if (skb == NULL)
-			continue;
-		len = skb->len;
+		skb_queue_splice_init(&rmnet_ll_ipa3_ctx->tx_queue, &batch);
+		rmnet_ll_ipa3_ctx->tx_draining = true;
+		pkts = skb_queue_len(&batch);
+		len = 0;
+		skb_queue_walk(&batch, skb)
+			len += skb->len;
 		spin_unlock_irqrestore(&rmnet_ll_ipa3_ctx->tx_lock, flags);
 		/*
 		 * both data packets and command will be routed to
 		 * IPA_CLIENT_Q6_WAN_CONS based on DMA settings
 		 */
-		ret = ipa3_tx_dp(IPA_CLIENT_APPS_WAN_LOW_LAT_DATA_PROD, skb, NULL);
-		if (ret) {
-			if (ret == -EPIPE) {
-				/* try to drain skb from queue if pipe teardown */
-				IPAERR_RL("Low lat data fatal: pipe is not valid\n");
-				spin_lock_irqsave(&rmnet_ll_ipa3_ctx->tx_lock,
-					flags);
-				rmnet_ll_ipa3_ctx->stats.tx_pkt_dropped++;
-				rmnet_ll_ipa3_ctx->stats.tx_byte_dropped +=
-					skb->len;
-				kfree_skb(skb);
-				continue;
-			}
+		ret = ipa3_tx_dp_list(IPA_CLIENT_APPS_WAN_LOW_LAT_DATA_PROD,
+			&batch, NULL);
+
+		/* packets left on the batch were not queued to IPA */
+		left_len = 0;
+		skb_queue_walk(&batch, skb)
+			left_len += skb->len;
+		atomic_add(pkts - skb_queue_len(&batch),
+			&rmnet_ll_ipa3_ctx->stats.outstanding_pkts);
+
+		spin_lock_irqsave(&rmnet_ll_ipa3_ctx->tx_lock, flags);
+		rmnet_ll_ipa3_ctx->stats.tx_pkt_sent +=
+			pkts - skb_queue_len(&batch);
+		rmnet_ll_ipa3_ctx->stats.tx_byte_sent += len - left_len;
+		if (!ret)
+			continue;
+
+		if (ret == -EPIPE) {
+			/* try to drain skb from queue if pipe teardown */
+			IPAERR_RL("Low lat data fatal: pipe is not valid\n");
+			rmnet_ll_ipa3_ctx->stats.tx_pkt_dropped +=
+				skb_queue_len(&batch);
+			rmnet_ll_ipa3_ctx->stats.tx_byte_dropped += left_len;
+			spin_unlock_irqrestore(&rmnet_ll_ipa3_ctx->tx_lock,
+				flags);
+			__skb_queue_purge(&batch);
 			spin_lock_irqsave(&rmnet_ll_ipa3_ctx->tx_lock, flags);
-			skb_queue_head(&rmnet_ll_ipa3_ctx->tx_queue, skb);
-			spin_unlock_irqrestore(&rmnet_ll_ipa3_ctx->tx_lock, flags);
-			goto delayed_work;
+			continue;
 		}
 
-		atomic_inc(&rmnet_ll_ipa3_ctx->stats.outstanding_pkts);
-		spin_lock_irqsave(&rmnet_ll_ipa3_ctx->tx_lock, flags);
-		rmnet_ll_ipa3_ctx->stats.tx_pkt_sent++;
-		rmnet_ll_ipa3_ctx->stats.tx_byte_sent += len;
+		/* put the rest back ahead of what was queued meanwhile */
+		skb_queue_splice(&batch, &rmnet_ll_ipa3_ctx->tx_queue);
+		rmnet_ll_ipa3_ctx->tx_draining = false;
+		spin_unlock_irqrestore(&rmnet_ll_ipa3_ctx->tx_lock, flags);
+		goto delayed_work;
 	}
+	rmnet_ll_ipa3_ctx->tx_draining = false;
 	spin_unlock_irqrestore(&rmnet_ll_ipa3_ctx->tx_lock, flags);
 	goto out;
 
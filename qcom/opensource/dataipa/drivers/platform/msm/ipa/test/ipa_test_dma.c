@@ -4,7 +4,9 @@
  */
 
 #include <linux/ipa.h>
+#include <linux/irq.h>
 #include "ipa_i.h"
+#include "gsi.h"
 #include "ipa_ut_framework.h"
 
 #define IPA_TEST_DMA_WQ_NAME_BUFF_SZ		64
@@ -1073,6 +1075,192 @@ static int ipa_test_dma_sync_memcpy_max_pkt_size(void *priv)
 	return 0;
 }
 
+/**
+ * ipa_test_dma_async_cons_evt() - event ring of the async consumer pipe
+ *
+ * Returns the GSI event ring context, NULL if the pipe is not connected
+ */
+static struct gsi_evt_ctx *ipa_test_dma_async_cons_evt(void)
+{
+	int ep_idx;
+
+	ep_idx = ipa3_get_ep_mapping(IPA_CLIENT_MEMCPY_DMA_ASYNC_CONS);
+	if (ep_idx < 0 || !ipa3_ctx->ep[ep_idx].valid) {
+		IPA_UT_LOG("async cons pipe not connected\n");
+		return NULL;
+	}
+
+	return &gsi_ctx->evtr[ipa3_ctx->ep[ep_idx].gsi_evt_ring_hdl];
+}
+
+/**
+ * TEST: Event ring interrupt statistics on async memory copy
+ *
+ *	1. dma enable
+ *	2. snapshot the async consumer event ring stats
+ *	3. async memcpy in loop
+ *	4. check that interrupts were accounted on the ring
+ *	5. dma disable
+ *
+ * Completions of async copies are delivered through the event ring
+ * interrupt, from a MSI, IEOB or, under emulation, the emulated
+ * interrupt controller.
+ */
+static int ipa_test_dma_async_memcpy_evt_irq_stats(void *priv)
+{
+	int rc;
+	struct gsi_evt_ctx *evt;
+	struct gsi_evt_stats before;
+
+	IPA_UT_LOG("Test Start\n");
+
+	rc = ipa_dma_enable();
+	if (rc) {
+		IPA_UT_LOG("DMA enable failed rc=%d\n", rc);
+		IPA_UT_TEST_FAIL_REPORT("fail enable dma");
+		return rc;
+	}
+
+	evt = ipa_test_dma_async_cons_evt();
+	if (!evt) {
+		IPA_UT_TEST_FAIL_REPORT("no async cons event ring");
+		(void)ipa_dma_disable();
+		return -EFAULT;
+	}
+	before = evt->stats;
+
+	IPA_DMA_RUN_TEST_UNIT_IN_LOOP(ipa_test_dma_memcpy_async,
+		IPA_DMA_TEST_INT_LOOP_NUM, rc,
+		IPA_TEST_DMA_MEMCPY_BUFF_SIZE, false);
+	if (rc) {
+		IPA_UT_LOG("Iterations of async memcpy failed rc=%d\n", rc);
+		IPA_UT_TEST_FAIL_REPORT("Iterations of async memcpy failed");
+		(void)ipa_dma_disable();
+		return rc;
+	}
+
+	IPA_UT_LOG("evt %u irqs %lu events %lu max %lu empty %lu\n",
+		evt->id, evt->stats.irqs - before.irqs,
+		evt->stats.irq_events - before.irq_events,
+		evt->stats.irq_events_max,
+		evt->stats.irq_empty - before.irq_empty);
+
+	if (evt->stats.irqs == before.irqs) {
+		IPA_UT_LOG("no interrupt accounted on evt %u\n", evt->id);
+		IPA_UT_TEST_FAIL_REPORT("no event ring interrupt accounted");
+		(void)ipa_dma_disable();
+		return -EFAULT;
+	}
+
+	if (evt->stats.irq_empty - before.irq_empty >
+		evt->stats.irqs - before.irqs) {
+		IPA_UT_TEST_FAIL_REPORT("more empty interrupts than interrupts");
+		(void)ipa_dma_disable();
+		return -EFAULT;
+	}
+
+	rc = ipa_dma_disable();
+	if (rc) {
+		IPA_UT_LOG("DMA disable failed rc=%d\n", rc);
+		IPA_UT_TEST_FAIL_REPORT("fail disable dma");
+		return rc;
+	}
+
+	return 0;
+}
+
+/**
+ * TEST: Steer the async consumer event ring interrupt to every cpu
+ *
+ *	1. dma enable
+ *	2. set the event ring interrupt affinity to each online cpu and
+ *	   check the irq affinity mask follows
+ *	3. async memcpy on each cpu setting
+ *	4. clear the affinity
+ *	5. dma disable
+ *
+ * Rings without a MSI of their own, e.g. under emulation, must refuse
+ * the affinity; the copies are still run.
+ */
+static int ipa_test_dma_evt_irq_affinity(void *priv)
+{
+	int rc;
+	int cpu;
+	u32 msi;
+	struct gsi_evt_ctx *evt;
+
+	IPA_UT_LOG("Test Start\n");
+
+	rc = ipa_dma_enable();
+	if (rc) {
+		IPA_UT_LOG("DMA enable failed rc=%d\n", rc);
+		IPA_UT_TEST_FAIL_REPORT("fail enable dma");
+		return rc;
+	}
+
+	evt = ipa_test_dma_async_cons_evt();
+	if (!evt) {
+		IPA_UT_TEST_FAIL_REPORT("no async cons event ring");
+		(void)ipa_dma_disable();
+		return -EFAULT;
+	}
+
+	for (msi = 0; msi < gsi_ctx->msi.num; msi++)
+		if (test_bit(msi, gsi_ctx->msi.used) &&
+			gsi_ctx->msi.evt[msi] == evt->id)
+			break;
+
+	for_each_online_cpu(cpu) {
+		rc = gsi_set_evt_ring_irq_affinity(evt->id, cpu);
+		if (msi == gsi_ctx->msi.num) {
+			if (rc != -GSI_STATUS_UNSUPPORTED_OP) {
+				IPA_UT_LOG("evt %u without MSI rc=%d\n",
+					evt->id, rc);
+				IPA_UT_TEST_FAIL_REPORT(
+					"affinity accepted without MSI");
+				(void)ipa_dma_disable();
+				return -EFAULT;
+			}
+		} else if (rc) {
+			IPA_UT_LOG("evt %u affinity to cpu %d failed rc=%d\n",
+				evt->id, cpu, rc);
+			IPA_UT_TEST_FAIL_REPORT("fail set irq affinity");
+			(void)ipa_dma_disable();
+			return rc;
+		} else if (!cpumask_test_cpu(cpu,
+			irq_get_affinity_mask(gsi_ctx->msi.irq[msi]))) {
+			IPA_UT_LOG("irq %u not affine to cpu %d\n",
+				gsi_ctx->msi.irq[msi], cpu);
+			IPA_UT_TEST_FAIL_REPORT("irq affinity not applied");
+			(void)gsi_set_evt_ring_irq_affinity(evt->id, -1);
+			(void)ipa_dma_disable();
+			return -EFAULT;
+		}
+
+		rc = ipa_test_dma_memcpy_async(IPA_TEST_DMA_MEMCPY_BUFF_SIZE,
+			false);
+		if (rc) {
+			IPA_UT_LOG("async memcpy on cpu %d failed rc=%d\n",
+				cpu, rc);
+			IPA_UT_TEST_FAIL_REPORT("async memcpy failed");
+			(void)gsi_set_evt_ring_irq_affinity(evt->id, -1);
+			(void)ipa_dma_disable();
+			return rc;
+		}
+	}
+
+	(void)gsi_set_evt_ring_irq_affinity(evt->id, -1);
+
+	rc = ipa_dma_disable();
+	if (rc) {
+		IPA_UT_LOG("DMA disable failed rc=%d\n", rc);
+		IPA_UT_TEST_FAIL_REPORT("fail disable dma");
+		return rc;
+	}
+
+	return 0;
+}
+
 /* Suite definition block */
 IPA_UT_DEFINE_SUITE_START(dma, "DMA for GSI",
 	ipa_test_dma_setup, ipa_test_dma_teardown)
@@ -1133,4 +1321,12 @@ IPA_UT_DEFINE_SUITE_START(dma, "DMA for GSI",
 		"Sync memory copy with max packet size",
 		ipa_test_dma_sync_memcpy_max_pkt_size,
 		true, IPA_HW_v3_0, IPA_HW_MAX),
+	IPA_UT_ADD_TEST(async_memcpy_evt_irq_stats,
+		"Event ring interrupt stats on async memory copy",
+		ipa_test_dma_async_memcpy_evt_irq_stats,
+		true, IPA_HW_v3_0, IPA_HW_MAX),
+	IPA_UT_ADD_TEST(evt_irq_affinity,
+		"Async memory copy with the event ring irq on each cpu",
+		ipa_test_dma_evt_irq_affinity,
+		true, IPA_HW_v3_0, IPA_HW_MAX),
 } IPA_UT_DEFINE_SUITE_END(dma);
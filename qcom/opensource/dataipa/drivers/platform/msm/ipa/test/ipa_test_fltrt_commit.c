@@ -0,0 +1,191 @@
+// SPDX-License-Identifier: GPL-2.0-only
+/*
+ * Copyright (c) 2023 Qualcomm Innovation Center, Inc. All rights reserved.
+ */
+
+#include "ipa_ut_framework.h"
+#include "ipa_i.h"
+
+/**
+ * Filter/routing commit IPA Unit-test suite
+ * Checks that the system memory table bodies a commit keeps are the same,
+ * byte for byte, as the ones a full regeneration produces, that the same
+ * holds for the H/W format rules kept by each entry, and that a commit
+ * with nothing changed is not written to the hw.
+ */
+
+static int ipa_test_fltrt_commit_suite_setup(void **ppriv)
+{
+	IPA_UT_DBG("Start Setup\n");
+
+	return 0;
+}
+
+static int ipa_test_fltrt_commit_suite_teardown(void *priv)
+{
+	IPA_UT_DBG("Start Teardown\n");
+
+	return 0;
+}
+
+static int ipa_test_fltrt_commit_verify(enum ipa_ip_type ip)
+{
+	int ret;
+
+	mutex_lock(&ipa3_ctx->lock);
+	ret = ipa3_flt_verify_tbl_bodies(ip);
+	if (!ret)
+		ret = ipa3_rt_verify_tbl_bodies(ip);
+	mutex_unlock(&ipa3_ctx->lock);
+
+	return ret;
+}
+
+/* the bodies kept after a commit match freshly generated ones */
+static int ipa_test_fltrt_commit_bodies(void *priv)
+{
+	enum ipa_ip_type ip;
+
+	for (ip = IPA_IP_v4; ip < IPA_IP_MAX; ip++) {
+		if (ipa3_commit_rt(ip)) {
+			IPA_UT_TEST_FAIL_REPORT("fail to commit");
+			return -EFAULT;
+		}
+
+		if (ipa_test_fltrt_commit_verify(ip)) {
+			IPA_UT_ERR("body mismatch ip=%d\n", ip);
+			IPA_UT_TEST_FAIL_REPORT("kept body mismatch");
+			return -EFAULT;
+		}
+	}
+
+	return 0;
+}
+
+/* a second commit without changes is skipped, an invalidated one is not */
+static int ipa_test_fltrt_commit_skip(void *priv)
+{
+	struct ipa3_fltrt_cmt_stats *flt, *rt;
+	u64 flt_skipped, rt_skipped, flt_commits, rt_commits;
+	enum ipa_ip_type ip;
+
+	for (ip = IPA_IP_v4; ip < IPA_IP_MAX; ip++) {
+		flt = &ipa3_ctx->stats.flt_cmt[ip];
+		rt = &ipa3_ctx->stats.rt_cmt[ip];
+
+		if (ipa3_commit_rt(ip)) {
+			IPA_UT_TEST_FAIL_REPORT("fail to commit");
+			return -EFAULT;
+		}
+
+		flt_skipped = flt->skipped;
+		rt_skipped = rt->skipped;
+		if (ipa3_commit_rt(ip)) {
+			IPA_UT_TEST_FAIL_REPORT("fail to commit");
+			return -EFAULT;
+		}
+		if (flt->skipped != flt_skipped + 1 ||
+			rt->skipped != rt_skipped + 1) {
+			IPA_UT_ERR("ip=%d flt skipped %llu->%llu rt %llu->%llu\n",
+				ip, flt_skipped, flt->skipped,
+				rt_skipped, rt->skipped);
+			IPA_UT_TEST_FAIL_REPORT("unchanged commit not skipped");
+			return -EFAULT;
+		}
+
+		mutex_lock(&ipa3_ctx->lock);
+		ipa3_flt_invalidate_tbls(ip);
+		ipa3_rt_invalidate_tbls(ip);
+		mutex_unlock(&ipa3_ctx->lock);
+
+		flt_commits = flt->commits;
+		rt_commits = rt->commits;
+		if (ipa3_commit_rt(ip)) {
+			IPA_UT_TEST_FAIL_REPORT("fail to commit");
+			return -EFAULT;
+		}
+		if (flt->commits != flt_commits + 1 ||
+			rt->commits != rt_commits + 1) {
+			IPA_UT_TEST_FAIL_REPORT("invalidated commit skipped");
+			return -EFAULT;
+		}
+
+		if (ipa_test_fltrt_commit_verify(ip)) {
+			IPA_UT_TEST_FAIL_REPORT("regenerated body mismatch");
+			return -EFAULT;
+		}
+	}
+
+	return 0;
+}
+
+/*
+ * the H/W format rules kept by the entries match the ones generated from
+ * scratch, and a commit with an invalidated table writes them from the
+ * entries instead of generating them again
+ */
+static int ipa_test_fltrt_commit_rules(void *priv)
+{
+	struct ipa3_fltrt_cmt_stats *flt, *rt;
+	u64 flt_gen, rt_gen;
+	enum ipa_ip_type ip;
+	int ret;
+
+	for (ip = IPA_IP_v4; ip < IPA_IP_MAX; ip++) {
+		flt = &ipa3_ctx->stats.flt_cmt[ip];
+		rt = &ipa3_ctx->stats.rt_cmt[ip];
+
+		if (ipa3_commit_rt(ip)) {
+			IPA_UT_TEST_FAIL_REPORT("fail to commit");
+			return -EFAULT;
+		}
+
+		mutex_lock(&ipa3_ctx->lock);
+		ret = ipa3_flt_verify_hw_rules(ip);
+		if (!ret)
+			ret = ipa3_rt_verify_hw_rules(ip);
+		ipa3_flt_invalidate_tbls(ip);
+		ipa3_rt_invalidate_tbls(ip);
+		mutex_unlock(&ipa3_ctx->lock);
+		if (ret) {
+			IPA_UT_ERR("kept rule mismatch ip=%d\n", ip);
+			IPA_UT_TEST_FAIL_REPORT("kept rule mismatch");
+			return -EFAULT;
+		}
+
+		flt_gen = flt->rule_gen;
+		rt_gen = rt->rule_gen;
+		if (ipa3_commit_rt(ip)) {
+			IPA_UT_TEST_FAIL_REPORT("fail to commit");
+			return -EFAULT;
+		}
+		if (flt->rule_gen != flt_gen || rt->rule_gen != rt_gen) {
+			IPA_UT_ERR("ip=%d flt rule_gen %llu->%llu rt %llu->%llu\n",
+				ip, flt_gen, flt->rule_gen, rt_gen, rt->rule_gen);
+			IPA_UT_TEST_FAIL_REPORT("unchanged rules regenerated");
+			return -EFAULT;
+		}
+
+		if (ipa_test_fltrt_commit_verify(ip)) {
+			IPA_UT_TEST_FAIL_REPORT("body from kept rules mismatch");
+			return -EFAULT;
+		}
+	}
+
+	return 0;
+}
+
+/* Suite definition block */
+IPA_UT_DEFINE_SUITE_START(fltrt_commit, "Filter/routing commit suite",
+	ipa_test_fltrt_commit_suite_setup, ipa_test_fltrt_commit_suite_teardown)
+{
+	IPA_UT_ADD_TEST(kept_bodies, "Kept bodies match regenerated ones",
+		ipa_test_fltrt_commit_bodies, true, IPA_HW_v3_0, IPA_HW_MAX),
+
+	IPA_UT_ADD_TEST(skip_unchanged, "Unchanged commits are skipped",
+		ipa_test_fltrt_commit_skip, true, IPA_HW_v3_0, IPA_HW_MAX),
+
+	IPA_UT_ADD_TEST(kept_rules, "Kept H/W rules match generated ones",
+		ipa_test_fltrt_commit_rules, true, IPA_HW_v3_0, IPA_HW_MAX),
+
+} IPA_UT_DEFINE_SUITE_END(fltrt_commit);
@@ -0,0 +1,268 @@
+// SPDX-License-Identifier: GPL-2.0-only
+/*
+ * Copyright (c) 2023 Qualcomm Innovation Center, Inc. All rights reserved.
+ */
+
+#include "ipa_ut_framework.h"
+#include "ipa_i.h"
+
+/**
+ * Name index IPA Unit-test suite
+ * Checks that header and routing table lookups through the name hash
+ * return the same object a linear walk of the lists returns, including
+ * when several header entries share the same name.
+ */
+
+#define IPA_TEST_NAME_INDEX_HDRS 64
+#define IPA_TEST_NAME_INDEX_HDR_LEN 4
+
+static struct ipa3_hdr_entry *ipa_test_name_index_walk_hdr(const char *name)
+{
+	struct ipa3_hdr_entry *entry;
+	enum hdr_tbl_storage hdr_tbl_loc;
+
+	for (hdr_tbl_loc = HDR_TBL_LCL; hdr_tbl_loc < HDR_TBLS_TOTAL; hdr_tbl_loc++) {
+		list_for_each_entry(entry,
+			&ipa3_ctx->hdr_tbl[hdr_tbl_loc].head_hdr_entry_list,
+			link) {
+			if (!strcmp(name, entry->name))
+				return entry;
+		}
+	}
+
+	return NULL;
+}
+
+static struct ipa3_rt_tbl *ipa_test_name_index_walk_rt(enum ipa_ip_type ip,
+	const char *name)
+{
+	struct ipa3_rt_tbl *entry;
+
+	list_for_each_entry(entry,
+		&ipa3_ctx->rt_tbl_set[ip].head_rt_tbl_list, link) {
+		if (!ipa3_check_idr_if_freed(entry) &&
+			!strcmp(name, entry->name))
+			return entry;
+	}
+
+	return NULL;
+}
+
+/* compare ipa3_get_hdr() against a list walk, return the handle found */
+static int ipa_test_name_index_check_hdr(const char *name, u32 *hdl)
+{
+	struct ipa_ioc_get_hdr lookup;
+	struct ipa3_hdr_entry *entry;
+	int ret;
+
+	memset(&lookup, 0, sizeof(lookup));
+	strlcpy(lookup.name, name, IPA_RESOURCE_NAME_MAX);
+	ret = ipa3_get_hdr(&lookup);
+
+	mutex_lock(&ipa3_ctx->lock);
+	entry = ipa_test_name_index_walk_hdr(name);
+	if ((entry == NULL) != (ret != 0) ||
+		(entry && entry->id != lookup.hdl)) {
+		mutex_unlock(&ipa3_ctx->lock);
+		IPA_UT_ERR("hdr %s: lookup ret=%d hdl=%u, walk hdl=%d\n",
+			name, ret, lookup.hdl, entry ? entry->id : -1);
+		return -EFAULT;
+	}
+	mutex_unlock(&ipa3_ctx->lock);
+
+	if (hdl)
+		*hdl = ret ? 0 : lookup.hdl;
+
+	return 0;
+}
+
+static int ipa_test_name_index_add_hdrs(struct ipa_ioc_add_hdr *hdrs,
+	int num, int first)
+{
+	struct ipa_hdr_add *hdr;
+	int i;
+
+	memset(hdrs, 0, sizeof(*hdrs) + num * sizeof(*hdr));
+	hdrs->commit = 0;
+	hdrs->num_hdrs = num;
+	for (i = 0; i < num; i++) {
+		hdr = &hdrs->hdr[i];
+		snprintf(hdr->name, IPA_RESOURCE_NAME_MAX, "ut_name_idx_%d",
+			(first + i) / 2);
+		hdr->hdr_len = IPA_TEST_NAME_INDEX_HDR_LEN;
+		hdr->hdr[0] = first + i;
+	}
+
+	if (ipa3_add_hdr(hdrs)) {
+		IPA_UT_ERR("failed to add headers\n");
+		return -EFAULT;
+	}
+
+	for (i = 0; i < num; i++) {
+		if (hdrs->hdr[i].status) {
+			IPA_UT_ERR("failed to add header %d\n", i);
+			return -EFAULT;
+		}
+	}
+
+	return 0;
+}
+
+static int ipa_test_name_index_del_hdrs(u32 *hdls, int num)
+{
+	struct ipa_ioc_del_hdr *del;
+	int i, ret;
+
+	del = kzalloc(sizeof(*del) + num * sizeof(del->hdl[0]), GFP_KERNEL);
+	if (!del)
+		return -ENOMEM;
+
+	del->commit = 0;
+	del->num_hdls = num;
+	for (i = 0; i < num; i++)
+		del->hdl[i].hdl = hdls[i];
+
+	ret = ipa3_del_hdr(del);
+	for (i = 0; !ret && i < num; i++)
+		if (del->hdl[i].status)
+			ret = -EFAULT;
+	kfree(del);
+
+	return ret;
+}
+
+static int ipa_test_name_index_suite_setup(void **ppriv)
+{
+	IPA_UT_DBG("Start Setup\n");
+
+	return 0;
+}
+
+static int ipa_test_name_index_suite_teardown(void *priv)
+{
+	IPA_UT_DBG("Start Teardown\n");
+
+	return 0;
+}
+
+/*
+ * Headers are added in pairs sharing a name, as kernel clients may do.
+ * The newest of a pair must be found first, then the older one once the
+ * newest is gone, and nothing once both are.
+ */
+static int ipa_test_name_index_hdr(void *priv)
+{
+	struct ipa_ioc_add_hdr *hdrs;
+	char name[IPA_RESOURCE_NAME_MAX];
+	u32 hdls[IPA_TEST_NAME_INDEX_HDRS];
+	u32 hdl;
+	int i, ret;
+
+	hdrs = kzalloc(sizeof(*hdrs) +
+		IPA_TEST_NAME_INDEX_HDRS * sizeof(hdrs->hdr[0]), GFP_KERNEL);
+	if (!hdrs) {
+		IPA_UT_TEST_FAIL_REPORT("fail to alloc headers");
+		return -ENOMEM;
+	}
+
+	ret = ipa_test_name_index_add_hdrs(hdrs, IPA_TEST_NAME_INDEX_HDRS, 0);
+	if (ret) {
+		IPA_UT_TEST_FAIL_REPORT("fail to add headers");
+		goto free;
+	}
+	for (i = 0; i < IPA_TEST_NAME_INDEX_HDRS; i++)
+		hdls[i] = hdrs->hdr[i].hdr_hdl;
+
+	for (i = 0; i < IPA_TEST_NAME_INDEX_HDRS; i += 2) {
+		ret = ipa_test_name_index_check_hdr(hdrs->hdr[i].name, &hdl);
+		if (ret || hdl != hdls[i + 1]) {
+			IPA_UT_TEST_FAIL_REPORT("newest header not found");
+			ret = -EFAULT;
+			goto del;
+		}
+	}
+
+	for (i = 1; i < IPA_TEST_NAME_INDEX_HDRS; i += 2) {
+		ret = ipa_test_name_index_del_hdrs(&hdls[i], 1);
+		hdls[i] = 0;
+		if (ret) {
+			IPA_UT_TEST_FAIL_REPORT("fail to del header");
+			goto del;
+		}
+		ret = ipa_test_name_index_check_hdr(hdrs->hdr[i].name, &hdl);
+		if (ret || hdl != hdls[i - 1]) {
+			IPA_UT_TEST_FAIL_REPORT("older header not found");
+			ret = -EFAULT;
+			goto del;
+		}
+	}
+
+	snprintf(name, IPA_RESOURCE_NAME_MAX, "ut_name_idx_none");
+	ret = ipa_test_name_index_check_hdr(name, &hdl);
+	if (ret || hdl) {
+		IPA_UT_TEST_FAIL_REPORT("unknown header found");
+		ret = -EFAULT;
+	}
+
+del:
+	for (i = 0; i < IPA_TEST_NAME_INDEX_HDRS; i++) {
+		if (hdls[i] && ipa_test_name_index_del_hdrs(&hdls[i], 1))
+			IPA_UT_ERR("fail to del header %d\n", i);
+		hdls[i] = 0;
+	}
+
+	for (i = 0; !ret && i < IPA_TEST_NAME_INDEX_HDRS; i++) {
+		ret = ipa_test_name_index_check_hdr(hdrs->hdr[i].name, &hdl);
+		if (ret || hdl) {
+			IPA_UT_TEST_FAIL_REPORT("deleted header found");
+			ret = -EFAULT;
+		}
+	}
+free:
+	kfree(hdrs);
+	return ret;
+}
+
+/* every routing table of a set must be found by name as a walk finds it */
+static int ipa_test_name_index_rt(void *priv)
+{
+	struct ipa3_rt_tbl *entry;
+	enum ipa_ip_type ip;
+	int ret = 0;
+
+	mutex_lock(&ipa3_ctx->lock);
+	for (ip = IPA_IP_v4; ip < IPA_IP_MAX; ip++) {
+		list_for_each_entry(entry,
+			&ipa3_ctx->rt_tbl_set[ip].head_rt_tbl_list, link) {
+			if (__ipa3_find_rt_tbl(ip, entry->name) !=
+				ipa_test_name_index_walk_rt(ip, entry->name)) {
+				IPA_UT_ERR("rt tbl %s ip=%d mismatch\n",
+					entry->name, ip);
+				ret = -EFAULT;
+			}
+		}
+
+		if (__ipa3_find_rt_tbl(ip, "ut_name_idx_none")) {
+			IPA_UT_ERR("unknown rt tbl found ip=%d\n", ip);
+			ret = -EFAULT;
+		}
+	}
+	mutex_unlock(&ipa3_ctx->lock);
+
+	if (ret)
+		IPA_UT_TEST_FAIL_REPORT("rt tbl lookup mismatch");
+
+	return ret;
+}
+
+/* Suite definition block */
+IPA_UT_DEFINE_SUITE_START(name_index, "Name index suite",
+	ipa_test_name_index_suite_setup, ipa_test_name_index_suite_teardown)
+{
+	IPA_UT_ADD_TEST(hdr_lookup, "Header lookup by name",
+		ipa_test_name_index_hdr, true, IPA_HW_v3_0, IPA_HW_MAX),
+
+	IPA_UT_ADD_TEST(rt_tbl_lookup, "Routing table lookup by name",
+		ipa_test_name_index_rt, true, IPA_HW_v3_0, IPA_HW_MAX),
+
+} IPA_UT_DEFINE_SUITE_END(name_index);
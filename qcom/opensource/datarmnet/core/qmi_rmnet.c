@@ -155,17 +155,28 @@ qmi_rmnet_clean_flow_list(struct qos_info *qos)
 
 	list_for_each_entry_safe(itm, fl_tmp, &qos->flow_head, list) {
 		list_del(&itm->list);
+		hash_del(&itm->hnode);
 		kfree(itm);
 	}
 
 	list_for_each_entry_safe(bearer, br_tmp, &qos->bearer_head, list) {
 		list_del(&bearer->list);
+		hash_del(&bearer->hnode);
 		kfree(bearer);
 	}
 
 	memset(qos->mq, 0, sizeof(qos->mq));
 }
 
+/* Flow and bearer maps are also hashed so the per packet lookups in
+ * qmi_rmnet_get_queue() do not walk every active flow. The lists are
+ * kept for the walks over all entries. Both are protected by qos_lock.
+ */
+static inline u32 qmi_rmnet_flow_key(u32 flow_id, int ip_type)
+{
+	return flow_id ^ ((u32)ip_type << 24);
+}
+
 struct rmnet_flow_map *
 qmi_rmnet_get_flow_map(struct qos_info *qos, u32 flow_id, int ip_type)
 {
@@ -174,10 +185,14 @@ qmi_rmnet_get_flow_map(struct qos_info *qos, u32 flow_id, int ip_type)
 	if (!qos)
 		return NULL;
 
-	list_for_each_entry(itm, &qos->flow_head, list) {
-		if ((itm->flow_id == flow_id) && (itm->ip_type == ip_type))
+	hash_for_each_possible(qos->flow_hash, itm, hnode,
+			       qmi_rmnet_flow_key(flow_id, ip_type)) {
+		if ((itm->flow_id == flow_id) && (itm->ip_type == ip_type)) {
+			qos->map_stats.flow_hit++;
 			return itm;
+		}
 	}
+	qos->map_stats.flow_miss++;
 	return NULL;
 }
 
@@ -189,10 +204,13 @@ qmi_rmnet_get_bearer_map(struct qos_info *qos, uint8_t bearer_id)
 	if (!qos)
 		return NULL;
 
-	list_for_each_entry(itm, &qos->bearer_head, list) {
-		if (itm->bearer_id == bearer_id)
+	hash_for_each_possible(qos->bearer_hash, itm, hnode, bearer_id) {
+		if (itm->bearer_id == bearer_id) {
+			qos->map_stats.bearer_hit++;
 			return itm;
+		}
 	}
+	qos->map_stats.bearer_miss++;
 	return NULL;
 }
 
@@ -335,6 +353,7 @@ static struct rmnet_bearer_map *__qmi_rmnet_bearer_get(
 		timer_setup(&bearer->ch_switch.guard_timer,
 			    rmnet_ll_guard_fn, 0);
 		list_add(&bearer->list, &qos_info->bearer_head);
+		hash_add(qos_info->bearer_hash, &bearer->hnode, bearer_id);
 	}
 
 	return bearer;
@@ -368,6 +387,7 @@ static void __qmi_rmnet_bearer_put(struct net_device *dev,
 
 		/* Remove from bearer map */
 		list_del(&bearer->list);
+		hash_del(&bearer->hnode);
 		qos_info->removed_bearer = bearer;
 	}
 }
@@ -488,6 +508,8 @@ again:
 
 	qmi_rmnet_update_flow_map(itm, &new_map);
 	list_add(&itm->list, &qos_info->flow_head);
+	hash_add(qos_info->flow_hash, &itm->hnode,
+		 qmi_rmnet_flow_key(itm->flow_id, itm->ip_type));
 
 	/* Create or update bearer map */
 	bearer = __qmi_rmnet_bearer_get(qos_info, new_map.bearer_id);
@@ -541,6 +563,7 @@ qmi_rmnet_del_flow(struct net_device *dev, struct tcmsg *tcm,
 
 		/* Remove from flow map */
 		list_del(&itm->list);
+		hash_del(&itm->hnode);
 		kfree(itm);
 	}
 
@@ -1074,6 +1097,24 @@ int qmi_rmnet_get_queue(struct net_device *dev, struct sk_buff *skb)
 }
 EXPORT_SYMBOL(qmi_rmnet_get_queue);
 
+int qmi_rmnet_get_map_stats(struct net_device *dev, u64 *s, int n)
+{
+	struct qos_info *qos;
+
+	rcu_read_lock();
+	qos = rmnet_get_qos_pt(dev);
+	if (qos && n > 0) {
+		n = min(n, (int)(sizeof(qos->map_stats) / sizeof(u64)));
+		spin_lock_bh(&qos->qos_lock);
+		memcpy(s, &qos->map_stats, n * sizeof(u64));
+		spin_unlock_bh(&qos->qos_lock);
+	}
+	rcu_read_unlock();
+
+	return n;
+}
+EXPORT_SYMBOL(qmi_rmnet_get_map_stats);
+
 inline unsigned int qmi_rmnet_grant_per(unsigned int grant)
 {
 	return grant / qmi_rmnet_scale_factor;
@@ -1095,6 +1136,8 @@ void *qmi_rmnet_qos_init(struct net_device *real_dev,
 	qos->tran_num = 0;
 	INIT_LIST_HEAD(&qos->flow_head);
 	INIT_LIST_HEAD(&qos->bearer_head);
+	hash_init(qos->flow_hash);
+	hash_init(qos->bearer_hash);
 	spin_lock_init(&qos->qos_lock);
 
 	return qos;
@@ -77,6 +77,7 @@ bool qmi_rmnet_get_flow_state(struct net_device *dev, struct sk_buff *skb,
 void qmi_rmnet_burst_fc_check(struct net_device *dev,
 			      int ip_type, u32 mark, unsigned int len);
 int qmi_rmnet_get_queue(struct net_device *dev, struct sk_buff *skb);
+int qmi_rmnet_get_map_stats(struct net_device *dev, u64 *s, int n);
 #else
 static inline void *
 qmi_rmnet_qos_init(struct net_device *real_dev,
@@ -112,6 +113,12 @@ static inline int qmi_rmnet_get_queue(struct net_device *dev,
 {
 	return 0;
 }
+
+static inline int qmi_rmnet_get_map_stats(struct net_device *dev,
+					  u64 *s, int n)
+{
+	return 0;
+}
 #endif
 
 #ifdef CONFIG_QTI_QMI_POWER_COLLAPSE
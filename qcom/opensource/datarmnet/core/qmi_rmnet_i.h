@@ -18,6 +18,7 @@
 #include <linux/netdevice.h>
 #include <linux/skbuff.h>
 #include <linux/timer.h>
+#include <linux/hashtable.h>
 #include <uapi/linux/rtnetlink.h>
 #include <linux/soc/qcom/qmi.h>
 
@@ -34,6 +35,9 @@
 #define DFC_MODE_SA 4
 #define PS_MAX_BEARERS 32
 
+#define QOS_FLOW_HASH_BITS 5
+#define QOS_BEARER_HASH_BITS 4
+
 #define CONFIG_QTI_QMI_RMNET 1
 #define CONFIG_QTI_QMI_DFC  1
 #define CONFIG_QTI_QMI_POWER_COLLAPSE 1
@@ -74,6 +78,7 @@ struct rmnet_ch_switch {
 
 struct rmnet_bearer_map {
 	struct list_head list;
+	struct hlist_node hnode;
 	u8 bearer_id;
 	int flow_ref;
 	u32 grant_size;
@@ -100,6 +105,7 @@ struct rmnet_bearer_map {
 
 struct rmnet_flow_map {
 	struct list_head list;
+	struct hlist_node hnode;
 	u8 bearer_id;
 	u32 flow_id;
 	int ip_type;
@@ -119,6 +125,14 @@ struct mq_map {
 	bool drop_on_remove;
 };
 
+/* Flow and bearer map lookup counters, under qos_lock */
+struct qos_map_stats {
+	u64 flow_hit;
+	u64 flow_miss;
+	u64 bearer_hit;
+	u64 bearer_miss;
+};
+
 struct qos_info {
 	struct list_head list;
 	u8 mux_id;
@@ -126,10 +140,13 @@ struct qos_info {
 	struct net_device *vnd_dev;
 	struct list_head flow_head;
 	struct list_head bearer_head;
+	DECLARE_HASHTABLE(flow_hash, QOS_FLOW_HASH_BITS);
+	DECLARE_HASHTABLE(bearer_hash, QOS_BEARER_HASH_BITS);
 	struct mq_map mq[MAX_MQ_NUM];
 	u32 tran_num;
 	spinlock_t qos_lock;
 	struct rmnet_bearer_map *removed_bearer;
+	struct qos_map_stats map_stats;
 };
 
 struct qmi_info {
@@ -57,6 +57,11 @@ struct rmnet_endpoint {
 struct rmnet_agg_stats {
 	u64 ul_agg_reuse;
 	u64 ul_agg_alloc;
+	u64 ul_agg_flush_size;
+	u64 ul_agg_flush_count;
+	u64 ul_agg_flush_time;
+	u64 ul_agg_flush_timer;
+	u64 ul_agg_flush_prio;
 };
 
 struct rmnet_port_priv_stats {
@@ -76,6 +81,7 @@ struct rmnet_port_priv_stats {
 	u64 dl_chain_stat[7];
 	u64 dl_frag_stat_1;
 	u64 dl_frag_stat[5];
+	u64 dl_desc_alloc;
 };
 
 struct rmnet_egress_agg_params {
@@ -101,6 +107,8 @@ struct rmnet_aggregation_state {
 	spinlock_t agg_lock;
 	struct sk_buff *agg_skb;
 	int (*send_agg_skb)(struct sk_buff *skb);
+	/* Smoothed packet inter-arrival time in ns */
+	u64 agg_gap;
 	int agg_state;
 	u8 agg_count;
 	u8 agg_size_order;
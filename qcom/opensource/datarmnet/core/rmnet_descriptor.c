@@ -51,6 +51,16 @@ typedef void (*rmnet_perf_tether_ingress_hook_t)(struct tcphdr *tp, struct sk_bu
 rmnet_perf_tether_ingress_hook_t rmnet_perf_tether_ingress_hook __rcu __read_mostly;
 EXPORT_SYMBOL(rmnet_perf_tether_ingress_hook);
 
+static void rmnet_frag_free(struct rmnet_frag_descriptor *frag_desc,
+			    struct rmnet_fragment *frag)
+{
+	list_del(&frag->list);
+	if (frag == &frag_desc->frag0)
+		frag_desc->frag0_used = 0;
+	else
+		kfree(frag);
+}
+
 struct rmnet_frag_descriptor *
 rmnet_get_frag_descriptor(struct rmnet_port *port)
 {
@@ -72,6 +82,7 @@ rmnet_get_frag_descriptor(struct rmnet_port *port)
 		INIT_LIST_HEAD(&frag_desc->list);
 		INIT_LIST_HEAD(&frag_desc->frags);
 		pool->pool_size++;
+		port->stats.dl_desc_alloc++;
 	}
 
 out:
@@ -95,8 +106,7 @@ void rmnet_recycle_frag_descriptor(struct rmnet_frag_descriptor *frag_desc,
 		if (page)
 			put_page(page);
 
-		list_del(&frag->list);
-		kfree(frag);
+		rmnet_frag_free(frag_desc, frag);
 	}
 
 	memset(frag_desc, 0, sizeof(*frag_desc));
@@ -133,10 +143,9 @@ void *rmnet_frag_pull(struct rmnet_frag_descriptor *frag_desc,
 			if (page)
 				put_page(page);
 
-			list_del(&frag->list);
 			size -= frag_size;
 			frag_desc->len -= frag_size;
-			kfree(frag);
+			rmnet_frag_free(frag_desc, frag);
 			continue;
 		}
 
@@ -183,10 +192,9 @@ void *rmnet_frag_trim(struct rmnet_frag_descriptor *frag_desc,
 			if (page)
 				put_page(page);
 
-			list_del(&frag->list);
 			eat -= frag_size;
 			frag_desc->len -= frag_size;
-			kfree(frag);
+			rmnet_frag_free(frag_desc, frag);
 			continue;
 		}
 
@@ -280,9 +288,15 @@ int rmnet_frag_descriptor_add_frag(struct rmnet_frag_descriptor *frag_desc,
 {
 	struct rmnet_fragment *frag;
 
-	frag = kzalloc(sizeof(*frag), GFP_ATOMIC);
-	if (!frag)
-		return -ENOMEM;
+	if (!frag_desc->frag0_used) {
+		frag = &frag_desc->frag0;
+		memset(frag, 0, sizeof(*frag));
+		frag_desc->frag0_used = 1;
+	} else {
+		frag = kzalloc(sizeof(*frag), GFP_ATOMIC);
+		if (!frag)
+			return -ENOMEM;
+	}
 
 	INIT_LIST_HEAD(&frag->list);
 	get_page(p);
@@ -1103,7 +1117,70 @@ void rmnet_frag_deliver(struct rmnet_frag_descriptor *frag_desc,
 }
 EXPORT_SYMBOL(rmnet_frag_deliver);
 
+/* Header fields of a coalesced frame that segments are derived from. These
+ * are read once per frame rather than once per segment, since looking them
+ * up may require copying the headers out of the fragments.
+ */
+struct rmnet_frag_coal_template {
+	__be32 tcp_seq;
+	__be16 tcp_flags;
+	__be16 ip_id;
+	u8 tcp_fin_psh:1,
+	   udp_zero_csum:1;
+};
+
+static int
+rmnet_frag_coal_template_init(struct rmnet_frag_descriptor *coal_desc,
+			      struct rmnet_frag_coal_template *tmpl)
+{
+	memset(tmpl, 0, sizeof(*tmpl));
+
+	if (coal_desc->trans_proto == IPPROTO_TCP) {
+		struct tcphdr *th, __th;
+		__be32 flag_word;
+
+		th = rmnet_frag_header_ptr(coal_desc, coal_desc->ip_len,
+					   sizeof(*th), &__th);
+		if (!th)
+			return -EINVAL;
+
+		tmpl->tcp_seq = th->seq;
+		tmpl->tcp_fin_psh = th->fin || th->psh;
+
+		/* Flags for all segments but the last, which must not carry
+		 * FIN or PSH.
+		 */
+		flag_word = tcp_flag_word(th);
+		flag_word &= ~TCP_FLAG_FIN;
+		flag_word &= ~TCP_FLAG_PSH;
+		tmpl->tcp_flags = *((__be16 *)&flag_word);
+	} else if (coal_desc->trans_proto == IPPROTO_UDP) {
+		struct udphdr *uh, __uh;
+
+		uh = rmnet_frag_header_ptr(coal_desc, coal_desc->ip_len,
+					   sizeof(*uh), &__uh);
+		if (!uh)
+			return -EINVAL;
+
+		tmpl->udp_zero_csum = coal_desc->ip_proto == 4 && !uh->check;
+	}
+
+	if (coal_desc->ip_proto == 4) {
+		struct iphdr *iph, __iph;
+
+		iph = rmnet_frag_header_ptr(coal_desc, 0, sizeof(*iph),
+					    &__iph);
+		if (!iph)
+			return -EINVAL;
+
+		tmpl->ip_id = iph->id;
+	}
+
+	return 0;
+}
+
 static void __rmnet_frag_segment_data(struct rmnet_frag_descriptor *coal_desc,
+				      struct rmnet_frag_coal_template *tmpl,
 				      struct rmnet_port *port,
 				      struct list_head *list, u8 pkt_id,
 				      bool csum_valid)
@@ -1123,6 +1200,7 @@ static void __rmnet_frag_segment_data(struct rmnet_frag_descriptor *coal_desc,
 	memcpy(new_desc, coal_desc, sizeof(*coal_desc));
 	INIT_LIST_HEAD(&new_desc->list);
 	INIT_LIST_HEAD(&new_desc->frags);
+	new_desc->frag0_used = 0;
 	new_desc->len = 0;
 
 	/* Add the header fragments */
@@ -1139,56 +1217,24 @@ static void __rmnet_frag_segment_data(struct rmnet_frag_descriptor *coal_desc,
 
 	/* Update protocol-specific metadata */
 	if (coal_desc->trans_proto == IPPROTO_TCP) {
-		struct tcphdr *th, __th;
-
-		th = rmnet_frag_header_ptr(coal_desc, coal_desc->ip_len,
-					   sizeof(*th), &__th);
-		if (!th)
-			goto recycle;
-
 		new_desc->tcp_seq_set = 1;
-		new_desc->tcp_seq = htonl(ntohl(th->seq) +
+		new_desc->tcp_seq = htonl(ntohl(tmpl->tcp_seq) +
 					  coal_desc->data_offset);
 
 		/* Don't allow any dangerous flags to appear in any segments
 		 * other than the last.
 		 */
-		if (th->fin || th->psh) {
-			if (offset + dlen < coal_desc->len) {
-				__be32 flag_word = tcp_flag_word(th);
-
-				/* Clear the FIN and PSH flags from this
-				 * segment.
-				 */
-				flag_word &= ~TCP_FLAG_FIN;
-				flag_word &= ~TCP_FLAG_PSH;
-
-				new_desc->tcp_flags_set = 1;
-				new_desc->tcp_flags = *((__be16 *)&flag_word);
-			}
+		if (tmpl->tcp_fin_psh && offset + dlen < coal_desc->len) {
+			new_desc->tcp_flags_set = 1;
+			new_desc->tcp_flags = tmpl->tcp_flags;
 		}
-	} else if (coal_desc->trans_proto == IPPROTO_UDP) {
-		struct udphdr *uh, __uh;
-
-		uh = rmnet_frag_header_ptr(coal_desc, coal_desc->ip_len,
-					   sizeof(*uh), &__uh);
-		if (!uh)
-			goto recycle;
-
-		if (coal_desc->ip_proto == 4 && !uh->check)
-			csum_valid = true;
+	} else if (tmpl->udp_zero_csum) {
+		csum_valid = true;
 	}
 
 	if (coal_desc->ip_proto == 4) {
-		struct iphdr *iph, __iph;
-
-		iph = rmnet_frag_header_ptr(coal_desc, 0, sizeof(*iph),
-					    &__iph);
-		if (!iph)
-			goto recycle;
-
 		new_desc->ip_id_set = 1;
-		new_desc->ip_id = htons(ntohs(iph->id) + coal_desc->pkt_id);
+		new_desc->ip_id = htons(ntohs(tmpl->ip_id) + coal_desc->pkt_id);
 	}
 
 	new_desc->csum_valid = csum_valid;
@@ -1252,6 +1298,7 @@ rmnet_frag_segment_coal_data(struct rmnet_frag_descriptor *coal_desc,
 {
 	struct rmnet_priv *priv = netdev_priv(coal_desc->dev);
 	struct rmnet_map_v5_coal_header coal_hdr;
+	struct rmnet_frag_coal_template tmpl;
 	struct rmnet_fragment *frag;
 	u8 *version;
 	u16 pkt_len;
@@ -1409,6 +1456,9 @@ rmnet_frag_segment_coal_data(struct rmnet_frag_descriptor *coal_desc,
 		return;
 	}
 
+	if (rmnet_frag_coal_template_init(coal_desc, &tmpl) < 0)
+		return;
+
 	/* Segment the coalesced descriptor into new packets */
 	for (nlo = 0; nlo < coal_hdr.num_nlos; nlo++) {
 		pkt_len = ntohs(coal_hdr.nl_pairs[nlo].pkt_len);
@@ -1426,8 +1476,9 @@ rmnet_frag_segment_coal_data(struct rmnet_frag_descriptor *coal_desc,
 				if (csum_err)
 					priv->stats.coal.coal_csum_err++;
 
-				__rmnet_frag_segment_data(coal_desc, port,
-							  list, total_pkt,
+				__rmnet_frag_segment_data(coal_desc, &tmpl,
+							  port, list,
+							  total_pkt,
 							  !csum_err);
 				continue;
 			}
@@ -1438,16 +1489,16 @@ rmnet_frag_segment_coal_data(struct rmnet_frag_descriptor *coal_desc,
 				/* Segment out the good data */
 				if (coal_desc->gso_segs)
 					__rmnet_frag_segment_data(coal_desc,
-								  port,
+								  &tmpl, port,
 								  list,
 								  total_pkt,
 								  true);
 
 				/* Segment out the bad checksum */
 				coal_desc->gso_segs = 1;
-				__rmnet_frag_segment_data(coal_desc, port,
-							  list, total_pkt,
-							  false);
+				__rmnet_frag_segment_data(coal_desc, &tmpl,
+							  port, list,
+							  total_pkt, false);
 			} else {
 				coal_desc->gso_segs++;
 			}
@@ -1458,7 +1509,7 @@ rmnet_frag_segment_coal_data(struct rmnet_frag_descriptor *coal_desc,
 		 * when the packet length changes.
 		 */
 		if (coal_desc->gso_segs)
-			__rmnet_frag_segment_data(coal_desc, port, list,
+			__rmnet_frag_segment_data(coal_desc, &tmpl, port, list,
 						  total_pkt, true);
 	}
 }
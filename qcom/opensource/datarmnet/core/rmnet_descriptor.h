@@ -36,6 +36,10 @@ struct rmnet_fragment {
 struct rmnet_frag_descriptor {
 	struct list_head list;
 	struct list_head frags;
+	/* Used for the first fragment so single page packets need no
+	 * separate rmnet_fragment allocation.
+	 */
+	struct rmnet_fragment frag0;
 	struct net_device *dev;
 	u32 coal_bufsize;
 	u32 coal_bytes;
@@ -59,7 +63,8 @@ struct rmnet_frag_descriptor {
 	   tcp_seq_set:1,
 	   flush_shs:1,
 	   tcp_flags_set:1,
-	   reserved:2;
+	   frag0_used:1,
+	   reserved:1;
 };
 
 /* Descriptor management */
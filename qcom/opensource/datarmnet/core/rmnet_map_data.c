@@ -31,6 +31,7 @@
 struct rmnet_map_coal_metadata {
 	void *ip_header;
 	void *trans_header;
+	__wsum pseudo_base;
 	u16 ip_len;
 	u16 trans_len;
 	u16 data_offset;
@@ -705,6 +706,40 @@ static void rmnet_map_gso_stamp(struct sk_buff *skb,
 	shinfo->gso_segs = coal_meta->pkt_count;
 }
 
+/* Sums the parts of the pseudoheader shared by every packet in a coalesced
+ * frame: the addresses and the protocol. Only the length differs between
+ * segments, so this is done once per frame instead of once per segment.
+ */
+static void rmnet_map_pseudo_base(struct rmnet_map_coal_metadata *coal_meta)
+{
+	__sum16 base;
+
+	if (coal_meta->ip_proto == 4) {
+		struct iphdr *iph = coal_meta->ip_header;
+
+		base = ~csum_tcpudp_magic(iph->saddr, iph->daddr, 0,
+					  coal_meta->trans_proto, 0);
+	} else {
+		struct ipv6hdr *ip6h = coal_meta->ip_header;
+
+		base = ~csum_ipv6_magic(&ip6h->saddr, &ip6h->daddr, 0,
+					coal_meta->trans_proto, 0);
+	}
+
+	coal_meta->pseudo_base = csum_unfold(base);
+}
+
+/* Completes the pseudoheader checksum for a datagram of the given length.
+ * The length is summed as a 32 bit big endian value, which is what both the
+ * IPv4 and IPv6 pseudoheaders reduce to once folded.
+ */
+static __sum16 rmnet_map_pseudo_csum(struct rmnet_map_coal_metadata *coal_meta,
+				     u32 datagram_len)
+{
+	return ~csum_fold(csum_add(coal_meta->pseudo_base,
+				   (__force __wsum)htonl(datagram_len)));
+}
+
 /* Handles setting up the partial checksum in the skb. Sets the transport
  * checksum to the pseudoheader checksum and sets the csum offload metadata
  */
@@ -715,18 +750,7 @@ static void rmnet_map_partial_csum(struct sk_buff *skb,
 	__sum16 pseudo;
 	u16 pkt_len = skb->len - coal_meta->ip_len;
 
-	if (coal_meta->ip_proto == 4) {
-		struct iphdr *iph = (struct iphdr *)data;
-
-		pseudo = ~csum_tcpudp_magic(iph->saddr, iph->daddr,
-					    pkt_len, coal_meta->trans_proto,
-					    0);
-	} else {
-		struct ipv6hdr *ip6h = (struct ipv6hdr *)data;
-
-		pseudo = ~csum_ipv6_magic(&ip6h->saddr, &ip6h->daddr,
-					  pkt_len, coal_meta->trans_proto, 0);
-	}
+	pseudo = rmnet_map_pseudo_csum(coal_meta, pkt_len);
 
 	if (coal_meta->trans_proto == IPPROTO_TCP) {
 		struct tcphdr *tp = (struct tcphdr *)(data + coal_meta->ip_len);
@@ -831,25 +855,9 @@ __rmnet_map_segment_coal_skb(struct sk_buff *coal_skb,
 		 */
 		__wsum csum;
 		unsigned int offset = skb_transport_offset(skbn);
-		__sum16 pseudo;
 
-		/* Calculate pseudo header */
-		if (coal_meta->ip_proto == 4) {
-			struct iphdr *iph = ip_hdr(skbn);
-
-			pseudo = ~csum_tcpudp_magic(iph->saddr, iph->daddr,
-						    skbn->len -
-						    coal_meta->ip_len,
-						    coal_meta->trans_proto, 0);
-		} else {
-			struct ipv6hdr *ip6h = ipv6_hdr(skbn);
-
-			pseudo = ~csum_ipv6_magic(&ip6h->saddr, &ip6h->daddr,
-						  skbn->len - coal_meta->ip_len,
-						  coal_meta->trans_proto, 0);
-		}
-
-		*check = pseudo;
+		*check = rmnet_map_pseudo_csum(coal_meta,
+					       skbn->len - coal_meta->ip_len);
 		csum = skb_checksum(skbn, offset, skbn->len - offset, 0);
 		/* Add 1 to corrupt. This cannot produce a final value of 0
 		 * since csum_fold() can't return a value of 0xFFFF.
@@ -879,26 +887,12 @@ __rmnet_map_segment_coal_skb(struct sk_buff *coal_skb,
 static bool rmnet_map_validate_csum(struct sk_buff *skb,
 				    struct rmnet_map_coal_metadata *meta)
 {
-	u8 *data = rmnet_map_data_ptr(skb);
 	unsigned int datagram_len;
 	__wsum csum;
 	__sum16 pseudo;
 
 	datagram_len = skb->len - meta->ip_len;
-	if (meta->ip_proto == 4) {
-		struct iphdr *iph = (struct iphdr *)data;
-
-		pseudo = ~csum_tcpudp_magic(iph->saddr, iph->daddr,
-					    datagram_len,
-					    meta->trans_proto, 0);
-	} else {
-		struct ipv6hdr *ip6h = (struct ipv6hdr *)data;
-
-		pseudo = ~csum_ipv6_magic(&ip6h->saddr, &ip6h->daddr,
-					  datagram_len, meta->trans_proto,
-					  0);
-	}
-
+	pseudo = rmnet_map_pseudo_csum(meta, datagram_len);
 	csum = skb_checksum(skb, meta->ip_len, datagram_len,
 			    csum_unfold(pseudo));
 	return !csum_fold(csum);
@@ -991,6 +985,8 @@ static void rmnet_map_segment_coal_skb(struct sk_buff *coal_skb,
 		return;
 	}
 
+	rmnet_map_pseudo_base(&coal_meta);
+
 	if (rmnet_map_v5_csum_buggy(coal_hdr) && !zero_csum) {
 		rmnet_map_move_headers(coal_skb);
 		/* Mark as valid if it checks out */
@@ -1230,6 +1226,12 @@ int rmnet_map_process_next_hdr_packet(struct sk_buff *skb,
 
 long rmnet_agg_time_limit __read_mostly = 1000000L;
 long rmnet_agg_bypass_time __read_mostly = 10000000L;
+long rmnet_agg_min_flush_time __read_mostly = 100000L;
+
+/* The flush timer fires after this many average inter-arrival times */
+#define RMNET_AGG_GAP_SCALE 2
+/* Weight of a new inter-arrival sample in the running average, as a shift */
+#define RMNET_AGG_GAP_SHIFT 3
 
 int rmnet_map_tx_agg_skip(struct sk_buff *skb, int offset)
 {
@@ -1270,6 +1272,7 @@ static void rmnet_map_flush_tx_packet_work(struct work_struct *work)
 	if (likely(state->agg_state == -EINPROGRESS)) {
 		/* Buffer may have already been shipped out */
 		if (likely(state->agg_skb)) {
+			state->stats->ul_agg_flush_timer++;
 			skb = state->agg_skb;
 			state->agg_skb = NULL;
 			state->agg_count = 0;
@@ -1457,6 +1460,47 @@ void rmnet_map_send_agg_skb(struct rmnet_aggregation_state *state)
 	hrtimer_cancel(&state->hrtimer);
 }
 
+/* Track the smoothed inter-arrival time of packets on this state */
+static void rmnet_map_agg_update_gap(struct rmnet_aggregation_state *state,
+				     struct timespec64 *diff)
+{
+	u64 gap;
+
+	if (diff->tv_sec < 0)
+		gap = 0;
+	else if (diff->tv_sec > 0 || diff->tv_nsec > rmnet_agg_bypass_time)
+		gap = rmnet_agg_bypass_time;
+	else
+		gap = diff->tv_nsec;
+
+	if (gap > state->agg_gap)
+		state->agg_gap += (gap - state->agg_gap) >> RMNET_AGG_GAP_SHIFT;
+	else
+		state->agg_gap -= (state->agg_gap - gap) >> RMNET_AGG_GAP_SHIFT;
+}
+
+/* With RMNET_AGG_ADAPTIVE_TIME, flush once no packet has arrived for a few
+ * average inter-arrival times, since the burst feeding the aggregate is most
+ * likely over by then. The configured aggregation time still bounds how long
+ * the first packet of the aggregate can be held.
+ */
+static ktime_t rmnet_map_agg_flush_time(struct rmnet_aggregation_state *state)
+{
+	struct timespec64 diff;
+	s64 limit = state->params.agg_time;
+	u64 timeout;
+
+	diff = timespec64_sub(state->agg_last, state->agg_time);
+	limit -= timespec64_to_ns(&diff);
+	if (limit < 0)
+		limit = 0;
+
+	timeout = max_t(u64, state->agg_gap * RMNET_AGG_GAP_SCALE,
+			rmnet_agg_min_flush_time);
+
+	return ns_to_ktime(min_t(u64, timeout, limit));
+}
+
 void rmnet_map_tx_aggregate(struct sk_buff *skb, struct rmnet_port *port,
 			    bool low_latency)
 {
@@ -1471,10 +1515,14 @@ new_packet:
 	spin_lock_bh(&state->agg_lock);
 	memcpy(&last, &state->agg_last, sizeof(last));
 	ktime_get_real_ts64(&state->agg_last);
+	diff = timespec64_sub(state->agg_last, last);
+	rmnet_map_agg_update_gap(state, &diff);
 
 	if ((port->data_format & RMNET_EGRESS_FORMAT_PRIORITY) &&
 	    (RMNET_LLM(skb->priority) || RMNET_APS_LLB(skb->priority))) {
 		/* Send out any aggregated SKBs we have */
+		if (state->agg_skb)
+			state->stats->ul_agg_flush_prio++;
 		rmnet_map_send_agg_skb(state);
 		/* Send out the priority SKB. Not holding agg_lock anymore */
 		skb->protocol = htons(ETH_P_MAP);
@@ -1486,7 +1534,6 @@ new_packet:
 		/* Check to see if we should agg first. If the traffic is very
 		 * sparse, don't aggregate. We will need to tune this later
 		 */
-		diff = timespec64_sub(state->agg_last, last);
 		size = state->params.agg_size - skb->len;
 
 		if (diff.tv_sec > 0 || diff.tv_nsec > rmnet_agg_bypass_time ||
@@ -1522,6 +1569,13 @@ new_packet:
 	if (skb->len > size ||
 	    state->agg_count >= state->params.agg_count ||
 	    diff.tv_sec > 0 || diff.tv_nsec > rmnet_agg_time_limit) {
+		if (skb->len > size)
+			state->stats->ul_agg_flush_size++;
+		else if (state->agg_count >= state->params.agg_count)
+			state->stats->ul_agg_flush_count++;
+		else
+			state->stats->ul_agg_flush_time++;
+
 		rmnet_map_send_agg_skb(state);
 		goto new_packet;
 	}
@@ -1531,7 +1585,14 @@ new_packet:
 	dev_kfree_skb_any(skb);
 
 schedule:
-	if (state->agg_state != -EINPROGRESS) {
+	if (state->params.agg_features & RMNET_AGG_ADAPTIVE_TIME) {
+		/* Re-arm on every packet so the timer tracks the gap since
+		 * the last one rather than a fixed delay from the first.
+		 */
+		state->agg_state = -EINPROGRESS;
+		hrtimer_start(&state->hrtimer, rmnet_map_agg_flush_time(state),
+			      HRTIMER_MODE_REL);
+	} else if (state->agg_state != -EINPROGRESS) {
 		state->agg_state = -EINPROGRESS;
 		hrtimer_start(&state->hrtimer,
 			      ns_to_ktime(state->params.agg_time),
@@ -1563,7 +1624,7 @@ void rmnet_map_update_ul_agg_config(struct rmnet_aggregation_state *state,
 	size -= SKB_DATA_ALIGN(sizeof(struct skb_shared_info));
 	state->params.agg_size = size;
 
-	if (state->params.agg_features == RMNET_PAGE_RECYCLE)
+	if (state->params.agg_features & RMNET_PAGE_RECYCLE)
 		rmnet_alloc_agg_pages(state);
 
 done:
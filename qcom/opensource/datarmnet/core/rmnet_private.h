@@ -39,8 +39,13 @@ RMNET_INGRESS_FORMAT_DL_MARKER_V2)
 #define RMNET_INGRESS_FORMAT_PS                 BIT(27)
 #define RMNET_FORMAT_PS_NOTIF                   BIT(26)
 
-/* UL Aggregation parameters */
+/* UL Aggregation parameters
+ * Feature bits of rmnet_egress_agg_params.agg_features, set by the
+ * userspace data daemon through IFLA_RMNET_UL_AGG_PARAMS on newlink or
+ * changelink.
+ */
 #define RMNET_PAGE_RECYCLE                      BIT(0)
+#define RMNET_AGG_ADAPTIVE_TIME                 BIT(1)
 
 /* Replace skb->dev to a virtual rmnet device and pass up the stack */
 #define RMNET_EPMODE_VND (1)
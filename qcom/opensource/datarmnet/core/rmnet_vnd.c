@@ -561,6 +561,11 @@ static const char rmnet_port_gstrings_stats[][ETH_GSTRING_LEN] = {
 	"DL trailer pkts received",
 	"UL agg reuse",
 	"UL agg alloc",
+	"UL agg flush size",
+	"UL agg flush count",
+	"UL agg flush time",
+	"UL agg flush timer",
+	"UL agg flush priority",
 	"DL chaining [0-10)",
 	"DL chaining [10-20)",
 	"DL chaining [20-30)",
@@ -574,6 +579,7 @@ static const char rmnet_port_gstrings_stats[][ETH_GSTRING_LEN] = {
 	"DL chaining frags [8-11]",
 	"DL chaining frags [12-15]",
 	"DL chaining frags = 16",
+	"DL descriptor allocations",
 };
 
 static const char rmnet_ll_gstrings_stats[][ETH_GSTRING_LEN] = {
@@ -603,6 +609,13 @@ static const char rmnet_qmap_gstrings_stats[][ETH_GSTRING_LEN] = {
 	"QMAP TX complete (MHI)",
 };
 
+static const char rmnet_qos_gstrings_stats[][ETH_GSTRING_LEN] = {
+	"QoS flow map hits",
+	"QoS flow map misses",
+	"QoS bearer map hits",
+	"QoS bearer map misses",
+};
+
 static void rmnet_get_strings(struct net_device *dev, u32 stringset, u8 *buf)
 {
 	size_t off = 0;
@@ -621,6 +634,9 @@ static void rmnet_get_strings(struct net_device *dev, u32 stringset, u8 *buf)
 		off += sizeof(rmnet_ll_gstrings_stats);
 		memcpy(buf + off, &rmnet_qmap_gstrings_stats,
 		       sizeof(rmnet_qmap_gstrings_stats));
+		off += sizeof(rmnet_qmap_gstrings_stats);
+		memcpy(buf + off, &rmnet_qos_gstrings_stats,
+		       sizeof(rmnet_qos_gstrings_stats));
 		break;
 	}
 }
@@ -632,7 +648,8 @@ static int rmnet_get_sset_count(struct net_device *dev, int sset)
 		return ARRAY_SIZE(rmnet_gstrings_stats) +
 		       ARRAY_SIZE(rmnet_port_gstrings_stats) +
 		       ARRAY_SIZE(rmnet_ll_gstrings_stats) +
-		       ARRAY_SIZE(rmnet_qmap_gstrings_stats);
+		       ARRAY_SIZE(rmnet_qmap_gstrings_stats) +
+		       ARRAY_SIZE(rmnet_qos_gstrings_stats);
 	default:
 		return -EOPNOTSUPP;
 	}
@@ -648,6 +665,7 @@ static void rmnet_get_ethtool_stats(struct net_device *dev,
 	struct rmnet_port *port;
 	size_t off = 0;
 	u64 qmap_s[ARRAY_SIZE(rmnet_qmap_gstrings_stats)];
+	u64 qos_s[ARRAY_SIZE(rmnet_qos_gstrings_stats)];
 
 	port = rmnet_get_port(priv->real_dev);
 
@@ -670,6 +688,12 @@ static void rmnet_get_ethtool_stats(struct net_device *dev,
 	rmnet_ctl_get_stats(qmap_s, ARRAY_SIZE(rmnet_qmap_gstrings_stats));
 	memcpy(data + off, qmap_s,
 	       ARRAY_SIZE(rmnet_qmap_gstrings_stats) * sizeof(u64));
+
+	off += ARRAY_SIZE(rmnet_qmap_gstrings_stats);
+	memset(qos_s, 0, sizeof(qos_s));
+	qmi_rmnet_get_map_stats(dev, qos_s, ARRAY_SIZE(rmnet_qos_gstrings_stats));
+	memcpy(data + off, qos_s,
+	       ARRAY_SIZE(rmnet_qos_gstrings_stats) * sizeof(u64));
 }
 
 static int rmnet_stats_reset(struct net_device *dev)
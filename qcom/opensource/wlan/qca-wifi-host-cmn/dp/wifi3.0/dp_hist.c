@@ -39,7 +39,7 @@
  * @index_11 = 11_12 ms
  * @index_12 = 12+ ms
  */
-static uint16_t dp_hist_sw_enq_dbucket[CDP_HIST_BUCKET_MAX] = {
+static const uint16_t dp_hist_sw_enq_dbucket[CDP_HIST_BUCKET_MAX] = {
 	0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12};
 
 /*
@@ -58,7 +58,7 @@ static uint16_t dp_hist_sw_enq_dbucket[CDP_HIST_BUCKET_MAX] = {
  * @index_11 = 250_500 ms
  * @index_12 = 500+ ms
  */
-static uint16_t dp_hist_fw2hw_dbucket[CDP_HIST_BUCKET_MAX] = {
+static const uint16_t dp_hist_fw2hw_dbucket[CDP_HIST_BUCKET_MAX] = {
 	0, 10, 20, 30, 40, 50, 60, 70, 80, 90, 100, 250, 500};
 #else
 /*
@@ -77,7 +77,7 @@ static uint16_t dp_hist_fw2hw_dbucket[CDP_HIST_BUCKET_MAX] = {
  * @index_11 = 8000_9000 us
  * @index_12 = 9000+ us
  */
-static uint16_t dp_hist_sw_enq_dbucket[CDP_HIST_BUCKET_MAX] = {
+static const uint16_t dp_hist_sw_enq_dbucket[CDP_HIST_BUCKET_MAX] = {
 	0, 250, 500, 750, 1000, 1500, 2000, 2500, 5000, 6000, 7000, 8000, 9000};
 
 /*
@@ -97,7 +97,7 @@ static uint16_t dp_hist_sw_enq_dbucket[CDP_HIST_BUCKET_MAX] = {
  * @index_12 = 9000+ us
  */
 
-static uint16_t dp_hist_fw2hw_dbucket[CDP_HIST_BUCKET_MAX] = {
+static const uint16_t dp_hist_fw2hw_dbucket[CDP_HIST_BUCKET_MAX] = {
 	0, 250, 500, 750, 1000, 1500, 2000, 2500, 5000, 6000, 7000, 8000, 9000};
 #endif
 
@@ -117,7 +117,7 @@ static uint16_t dp_hist_fw2hw_dbucket[CDP_HIST_BUCKET_MAX] = {
  * @index_11 = 56_60 ms
  * @index_12 = 60+ ms
  */
-static uint16_t dp_hist_reap2stack_bucket[CDP_HIST_BUCKET_MAX] = {
+static const uint16_t dp_hist_reap2stack_bucket[CDP_HIST_BUCKET_MAX] = {
 	0, 5, 10, 15, 20, 25, 30, 35, 40, 45, 50, 55, 60};
 
 /*
@@ -136,7 +136,7 @@ static uint16_t dp_hist_reap2stack_bucket[CDP_HIST_BUCKET_MAX] = {
  * @index_11 = 8000_9000 us
  * @index_12 = 9000+ us
  */
-static uint16_t dp_hist_hw_tx_comp_dbucket[CDP_HIST_BUCKET_MAX] = {
+static const uint16_t dp_hist_hw_tx_comp_dbucket[CDP_HIST_BUCKET_MAX] = {
 	0, 250, 500, 750, 1000, 1500, 2000, 2500, 5000, 6000, 7000, 8000, 9000};
 
 static const char *dp_hist_hw_tx_comp_dbucket_str[CDP_HIST_BUCKET_MAX + 1] = {
@@ -172,7 +172,7 @@ const char *dp_hist_tx_hw_delay_str(uint8_t index)
  * @index_11 = 150_200
  * @index_12 = 200+
  */
-static uint16_t dp_hist_delay_percentile_dbucket[CDP_HIST_BUCKET_MAX] = {
+static const uint16_t dp_hist_delay_percentile_dbucket[CDP_HIST_BUCKET_MAX] = {
 	0, 10, 20, 30, 40, 50, 60, 70, 80, 90, 100, 150, 200};
 
 static
@@ -192,23 +192,57 @@ const char *dp_hist_delay_percentile_str(uint8_t index)
 	return dp_hist_delay_percentile_dbucket_str[index];
 }
 
+/*
+ * dp_hist_get_bucket_array: Get the bucket boundaries of a histogram type
+ * @hist_type: Histogram type
+ *
+ * Return: Bucket array, NULL for an unknown histogram type
+ */
+static inline const uint16_t *
+dp_hist_get_bucket_array(enum cdp_hist_types hist_type)
+{
+	switch (hist_type) {
+	case CDP_HIST_TYPE_SW_ENQEUE_DELAY:
+		return dp_hist_sw_enq_dbucket;
+	case CDP_HIST_TYPE_HW_COMP_DELAY:
+		return dp_hist_fw2hw_dbucket;
+	case CDP_HIST_TYPE_REAP_STACK:
+		return dp_hist_reap2stack_bucket;
+	case CDP_HIST_TYPE_HW_TX_COMP_DELAY:
+		return dp_hist_hw_tx_comp_dbucket;
+	case CDP_HIST_TYPE_DELAY_PERCENTILE:
+		return dp_hist_delay_percentile_dbucket;
+	default:
+		return NULL;
+	}
+}
+
 /*
  * dp_hist_find_bucket_idx: Find the bucket index
- * @bucket_array: Bucket array
+ * @bucket_array: Bucket array, sorted, starting at 0
  * @value: Frequency value
  *
+ * Binary search for the last bucket whose lower boundary is not above
+ * @value. Each step only selects the base pointer, which the compiler
+ * turns into a conditional move, so the lookup is a fixed sequence of
+ * log2(CDP_HIST_BUCKET_MAX) compares without data dependent branches.
+ *
  * Return: The bucket index
  */
-static int dp_hist_find_bucket_idx(int16_t *bucket_array, int value)
+static inline int dp_hist_find_bucket_idx(const uint16_t *bucket_array,
+					  int value)
 {
-	uint8_t idx = CDP_HIST_BUCKET_0;
+	const uint16_t *base = bucket_array;
+	uint8_t len = CDP_HIST_BUCKET_MAX;
+	uint8_t half;
 
-	for (; idx < (CDP_HIST_BUCKET_MAX - 1); idx++) {
-		if (value < bucket_array[idx + 1])
-			break;
+	while (len > 1) {
+		half = len / 2;
+		base = (value >= base[half]) ? base + half : base;
+		len -= half;
 	}
 
-	return idx;
+	return base - bucket_array;
 }
 
 /*
@@ -220,44 +254,17 @@ static int dp_hist_find_bucket_idx(int16_t *bucket_array, int value)
  */
 static void dp_hist_fill_buckets(struct cdp_hist_bucket *hist_bucket, int value)
 {
-	enum cdp_hist_types hist_type;
-	int idx = CDP_HIST_BUCKET_MAX;
+	const uint16_t *bucket_array;
 
 	if (qdf_unlikely(!hist_bucket))
 		return;
 
-	hist_type = hist_bucket->hist_type;
-
 	/* Identify the bucket the bucket and update. */
-	switch (hist_type) {
-	case CDP_HIST_TYPE_SW_ENQEUE_DELAY:
-		idx =  dp_hist_find_bucket_idx(&dp_hist_sw_enq_dbucket[0],
-					       value);
-		break;
-	case CDP_HIST_TYPE_HW_COMP_DELAY:
-		idx =  dp_hist_find_bucket_idx(&dp_hist_fw2hw_dbucket[0],
-					       value);
-		break;
-	case CDP_HIST_TYPE_REAP_STACK:
-		idx =  dp_hist_find_bucket_idx(
-				&dp_hist_reap2stack_bucket[0], value);
-		break;
-	case CDP_HIST_TYPE_HW_TX_COMP_DELAY:
-		idx =  dp_hist_find_bucket_idx(
-				&dp_hist_hw_tx_comp_dbucket[0], value);
-		break;
-	case CDP_HIST_TYPE_DELAY_PERCENTILE:
-		idx =  dp_hist_find_bucket_idx(
-				&dp_hist_delay_percentile_dbucket[0], value);
-		break;
-	default:
-		break;
-	}
-
-	if (idx == CDP_HIST_BUCKET_MAX)
+	bucket_array = dp_hist_get_bucket_array(hist_bucket->hist_type);
+	if (qdf_unlikely(!bucket_array))
 		return;
 
-	hist_bucket->freq[idx]++;
+	hist_bucket->freq[dp_hist_find_bucket_idx(bucket_array, value)]++;
 }
 
 /*
@@ -345,6 +352,46 @@ void dp_accumulate_hist_stats(struct cdp_hist_stats *src_hist_stats,
 	}
 }
 
+/*
+ * dp_hist_get_percentile(): Get a percentile of the histogram
+ * @hist_stats: Hist stats object
+ * @per_mille: Percentile in tenths of a percent, e.g. 999 for p99.9
+ *
+ * Return: Lower boundary of the bucket holding the percentile, -1 if the
+ *	   histogram is empty or of an unknown type
+ */
+int dp_hist_get_percentile(struct cdp_hist_stats *hist_stats,
+			   uint16_t per_mille)
+{
+	const uint16_t *bucket_array;
+	uint64_t total = 0;
+	uint64_t rank;
+	uint8_t index;
+
+	bucket_array = dp_hist_get_bucket_array(hist_stats->hist.hist_type);
+	if (!bucket_array)
+		return -1;
+
+	for (index = 0; index < CDP_HIST_BUCKET_MAX; index++)
+		total += hist_stats->hist.freq[index];
+
+	if (!total)
+		return -1;
+
+	/* 1-based rank of the sample at the percentile, rounded up */
+	rank = qdf_do_div(total * QDF_MIN(per_mille, 1000) + 999, 1000);
+	if (!rank)
+		rank = 1;
+
+	for (index = 0; index < CDP_HIST_BUCKET_MAX - 1; index++) {
+		if (hist_stats->hist.freq[index] >= rank)
+			break;
+		rank -= hist_stats->hist.freq[index];
+	}
+
+	return bucket_array[index];
+}
+
 /*
  * dp_hist_init(): Initialize the histogram object
  * @hist_stats: Hist stats object
@@ -41,6 +41,8 @@ void dp_accumulate_hist_stats(struct cdp_hist_stats *src_hist_stats,
 			      struct cdp_hist_stats *dst_hist_stats);
 void dp_copy_hist_stats(struct cdp_hist_stats *src_hist_stats,
 			struct cdp_hist_stats *dst_hist_stats);
+int dp_hist_get_percentile(struct cdp_hist_stats *hist_stats,
+			   uint16_t per_mille);
 const char *dp_hist_tx_hw_delay_str(uint8_t index);
 const char *dp_hist_delay_percentile_str(uint8_t index);
 #endif /* __DP_HIST_H_ */
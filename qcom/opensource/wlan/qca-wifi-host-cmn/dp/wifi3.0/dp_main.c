@@ -10381,6 +10381,7 @@ dp_print_host_stats(struct dp_vdev *vdev,
 	case TXRX_AST_STATS:
 		dp_print_ast_stats(pdev->soc);
 		dp_print_mec_stats(pdev->soc);
+		dp_print_peer_hash_stats(pdev->soc);
 		dp_print_peer_table(vdev);
 		break;
 	case TXRX_SRNG_PTR_STATS:
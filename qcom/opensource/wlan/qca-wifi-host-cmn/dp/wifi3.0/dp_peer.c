@@ -393,6 +393,67 @@ dp_peer_find_hash_index(struct dp_soc *soc,
 	return index;
 }
 
+/*
+ * dp_peer_hash_lock() - get the lock protecting a peer hash bin
+ * @soc: soc handle
+ * @index: peer hash bin index
+ *
+ * Bins are spread over DP_PEER_HASH_LOCKS locks so that lookups, adds and
+ * removes of peers hashing to different bins do not contend.
+ *
+ * return: lock of the bin
+ */
+static inline qdf_spinlock_t *dp_peer_hash_lock(struct dp_soc *soc,
+						 uint32_t index)
+{
+	return &soc->peer_hash_lock[index & (DP_PEER_HASH_LOCKS - 1)];
+}
+
+static void dp_peer_hash_lock_create(struct dp_soc *soc)
+{
+	int i;
+
+	for (i = 0; i < DP_PEER_HASH_LOCKS; i++)
+		qdf_spinlock_create(&soc->peer_hash_lock[i]);
+}
+
+static void dp_peer_hash_lock_destroy(struct dp_soc *soc)
+{
+	int i;
+
+	for (i = 0; i < DP_PEER_HASH_LOCKS; i++)
+		qdf_spinlock_destroy(&soc->peer_hash_lock[i]);
+}
+
+void dp_print_peer_hash_stats(struct dp_soc *soc)
+{
+	uint32_t i, len, used = 0, peers = 0, max_len = 0;
+	struct dp_peer *peer;
+
+	if (!soc->peer_hash.bins)
+		return;
+
+	for (i = 0; i <= soc->peer_hash.mask; i++) {
+		len = 0;
+		qdf_spin_lock_bh(dp_peer_hash_lock(soc, i));
+		TAILQ_FOREACH(peer, &soc->peer_hash.bins[i], hash_list_elem)
+			len++;
+		qdf_spin_unlock_bh(dp_peer_hash_lock(soc, i));
+
+		if (!len)
+			continue;
+		used++;
+		peers += len;
+		max_len = QDF_MAX(max_len, len);
+	}
+
+	DP_PRINT_STATS("Peer Hash Stats:");
+	DP_PRINT_STATS("	Bins = %u Locks = %u", soc->peer_hash.mask + 1,
+		       DP_PEER_HASH_LOCKS);
+	DP_PRINT_STATS("	Peers = %u Used bins = %u Longest chain = %u",
+		       peers, used, max_len);
+}
+
 /*
  * dp_peer_find_hash_find() - returns legacy or mlo link peer from
  *			      peer_hash_table matching vdev_id and mac_address
@@ -426,7 +487,7 @@ struct dp_peer *dp_peer_find_hash_find(
 		mac_addr = &local_mac_addr_aligned;
 	}
 	index = dp_peer_find_hash_index(soc, mac_addr);
-	qdf_spin_lock_bh(&soc->peer_hash_lock);
+	qdf_spin_lock_bh(dp_peer_hash_lock(soc, index));
 	TAILQ_FOREACH(peer, &soc->peer_hash.bins[index], hash_list_elem) {
 		if (dp_peer_find_mac_addr_cmp(mac_addr, &peer->mac_addr) == 0 &&
 		    ((peer->vdev->vdev_id == vdev_id) ||
@@ -436,11 +497,11 @@ struct dp_peer *dp_peer_find_hash_find(
 						QDF_STATUS_SUCCESS)
 				peer = NULL;
 
-			qdf_spin_unlock_bh(&soc->peer_hash_lock);
+			qdf_spin_unlock_bh(dp_peer_hash_lock(soc, index));
 			return peer;
 		}
 	}
-	qdf_spin_unlock_bh(&soc->peer_hash_lock);
+	qdf_spin_unlock_bh(dp_peer_hash_lock(soc, index));
 	return NULL; /* failure */
 }
 
@@ -458,7 +519,7 @@ static void dp_peer_find_hash_detach(struct dp_soc *soc)
 	if (soc->peer_hash.bins) {
 		qdf_mem_free(soc->peer_hash.bins);
 		soc->peer_hash.bins = NULL;
-		qdf_spinlock_destroy(&soc->peer_hash_lock);
+		dp_peer_hash_lock_destroy(soc);
 	}
 
 	if (soc->arch_ops.mlo_peer_find_hash_detach)
@@ -493,7 +554,7 @@ static QDF_STATUS dp_peer_find_hash_attach(struct dp_soc *soc)
 	for (i = 0; i < hash_elems; i++)
 		TAILQ_INIT(&soc->peer_hash.bins[i]);
 
-	qdf_spinlock_create(&soc->peer_hash_lock);
+	dp_peer_hash_lock_create(soc);
 
 	if (soc->arch_ops.mlo_peer_find_hash_attach &&
 	    (soc->arch_ops.mlo_peer_find_hash_attach(soc) !=
@@ -518,13 +579,13 @@ void dp_peer_find_hash_add(struct dp_soc *soc, struct dp_peer *peer)
 
 	index = dp_peer_find_hash_index(soc, &peer->mac_addr);
 	if (peer->peer_type == CDP_LINK_PEER_TYPE) {
-		qdf_spin_lock_bh(&soc->peer_hash_lock);
+		qdf_spin_lock_bh(dp_peer_hash_lock(soc, index));
 
 		if (QDF_IS_STATUS_ERROR(dp_peer_get_ref(soc, peer,
 							DP_MOD_ID_CONFIG))) {
 			dp_err("fail to get peer ref:" QDF_MAC_ADDR_FMT,
 			       QDF_MAC_ADDR_REF(peer->mac_addr.raw));
-			qdf_spin_unlock_bh(&soc->peer_hash_lock);
+			qdf_spin_unlock_bh(dp_peer_hash_lock(soc, index));
 			return;
 		}
 
@@ -538,7 +599,7 @@ void dp_peer_find_hash_add(struct dp_soc *soc, struct dp_peer *peer)
 		TAILQ_INSERT_TAIL(&soc->peer_hash.bins[index], peer,
 				  hash_list_elem);
 
-		qdf_spin_unlock_bh(&soc->peer_hash_lock);
+		qdf_spin_unlock_bh(dp_peer_hash_lock(soc, index));
 	} else if (peer->peer_type == CDP_MLD_PEER_TYPE) {
 		if (soc->arch_ops.mlo_peer_find_hash_add)
 			soc->arch_ops.mlo_peer_find_hash_add(soc, peer);
@@ -566,7 +627,7 @@ void dp_peer_find_hash_remove(struct dp_soc *soc, struct dp_peer *peer)
 		/* Check if tail is not empty before delete*/
 		QDF_ASSERT(!TAILQ_EMPTY(&soc->peer_hash.bins[index]));
 
-		qdf_spin_lock_bh(&soc->peer_hash_lock);
+		qdf_spin_lock_bh(dp_peer_hash_lock(soc, index));
 		TAILQ_FOREACH(tmppeer, &soc->peer_hash.bins[index],
 			      hash_list_elem) {
 			if (tmppeer == peer) {
@@ -579,7 +640,7 @@ void dp_peer_find_hash_remove(struct dp_soc *soc, struct dp_peer *peer)
 			     hash_list_elem);
 
 		dp_peer_unref_delete(peer, DP_MOD_ID_CONFIG);
-		qdf_spin_unlock_bh(&soc->peer_hash_lock);
+		qdf_spin_unlock_bh(dp_peer_hash_lock(soc, index));
 	} else if (peer->peer_type == CDP_MLD_PEER_TYPE) {
 		if (soc->arch_ops.mlo_peer_find_hash_remove)
 			soc->arch_ops.mlo_peer_find_hash_remove(soc, peer);
@@ -610,7 +671,7 @@ static QDF_STATUS dp_peer_find_hash_attach(struct dp_soc *soc)
 	for (i = 0; i < hash_elems; i++)
 		TAILQ_INIT(&soc->peer_hash.bins[i]);
 
-	qdf_spinlock_create(&soc->peer_hash_lock);
+	dp_peer_hash_lock_create(soc);
 	return QDF_STATUS_SUCCESS;
 }
 
@@ -619,7 +680,7 @@ static void dp_peer_find_hash_detach(struct dp_soc *soc)
 	if (soc->peer_hash.bins) {
 		qdf_mem_free(soc->peer_hash.bins);
 		soc->peer_hash.bins = NULL;
-		qdf_spinlock_destroy(&soc->peer_hash_lock);
+		dp_peer_hash_lock_destroy(soc);
 	}
 }
 
@@ -628,12 +689,12 @@ void dp_peer_find_hash_add(struct dp_soc *soc, struct dp_peer *peer)
 	unsigned index;
 
 	index = dp_peer_find_hash_index(soc, &peer->mac_addr);
-	qdf_spin_lock_bh(&soc->peer_hash_lock);
+	qdf_spin_lock_bh(dp_peer_hash_lock(soc, index));
 
 	if (QDF_IS_STATUS_ERROR(dp_peer_get_ref(soc, peer, DP_MOD_ID_CONFIG))) {
 		dp_err("unable to get peer ref at MAP mac: "QDF_MAC_ADDR_FMT,
 		       QDF_MAC_ADDR_REF(peer->mac_addr.raw));
-		qdf_spin_unlock_bh(&soc->peer_hash_lock);
+		qdf_spin_unlock_bh(dp_peer_hash_lock(soc, index));
 		return;
 	}
 
@@ -646,7 +707,7 @@ void dp_peer_find_hash_add(struct dp_soc *soc, struct dp_peer *peer)
 	 */
 	TAILQ_INSERT_TAIL(&soc->peer_hash.bins[index], peer, hash_list_elem);
 
-	qdf_spin_unlock_bh(&soc->peer_hash_lock);
+	qdf_spin_unlock_bh(dp_peer_hash_lock(soc, index));
 }
 
 void dp_peer_find_hash_remove(struct dp_soc *soc, struct dp_peer *peer)
@@ -659,7 +720,7 @@ void dp_peer_find_hash_remove(struct dp_soc *soc, struct dp_peer *peer)
 	/* Check if tail is not empty before delete*/
 	QDF_ASSERT(!TAILQ_EMPTY(&soc->peer_hash.bins[index]));
 
-	qdf_spin_lock_bh(&soc->peer_hash_lock);
+	qdf_spin_lock_bh(dp_peer_hash_lock(soc, index));
 	TAILQ_FOREACH(tmppeer, &soc->peer_hash.bins[index], hash_list_elem) {
 		if (tmppeer == peer) {
 			found = 1;
@@ -670,7 +731,7 @@ void dp_peer_find_hash_remove(struct dp_soc *soc, struct dp_peer *peer)
 	TAILQ_REMOVE(&soc->peer_hash.bins[index], peer, hash_list_elem);
 
 	dp_peer_unref_delete(peer, DP_MOD_ID_CONFIG);
-	qdf_spin_unlock_bh(&soc->peer_hash_lock);
+	qdf_spin_unlock_bh(dp_peer_hash_lock(soc, index));
 }
 
 
@@ -1087,7 +1148,7 @@ static bool dp_peer_exist_on_pdev(struct dp_soc *soc,
 		mac_addr = &local_mac_addr_aligned;
 	}
 	index = dp_peer_find_hash_index(soc, mac_addr);
-	qdf_spin_lock_bh(&soc->peer_hash_lock);
+	qdf_spin_lock_bh(dp_peer_hash_lock(soc, index));
 	TAILQ_FOREACH(peer, &soc->peer_hash.bins[index], hash_list_elem) {
 		if (dp_peer_find_mac_addr_cmp(mac_addr, &peer->mac_addr) == 0 &&
 		    (peer->vdev->pdev == pdev)) {
@@ -1095,7 +1156,7 @@ static bool dp_peer_exist_on_pdev(struct dp_soc *soc,
 			break;
 		}
 	}
-	qdf_spin_unlock_bh(&soc->peer_hash_lock);
+	qdf_spin_unlock_bh(dp_peer_hash_lock(soc, index));
 
 	if (found)
 		return found;
@@ -1131,7 +1192,7 @@ static bool dp_peer_exist_on_pdev(struct dp_soc *soc,
 		mac_addr = &local_mac_addr_aligned;
 	}
 	index = dp_peer_find_hash_index(soc, mac_addr);
-	qdf_spin_lock_bh(&soc->peer_hash_lock);
+	qdf_spin_lock_bh(dp_peer_hash_lock(soc, index));
 	TAILQ_FOREACH(peer, &soc->peer_hash.bins[index], hash_list_elem) {
 		if (dp_peer_find_mac_addr_cmp(mac_addr, &peer->mac_addr) == 0 &&
 		    (peer->vdev->pdev == pdev)) {
@@ -1139,7 +1200,7 @@ static bool dp_peer_exist_on_pdev(struct dp_soc *soc,
 			break;
 		}
 	}
-	qdf_spin_unlock_bh(&soc->peer_hash_lock);
+	qdf_spin_unlock_bh(dp_peer_hash_lock(soc, index));
 	return found;
 }
 #endif /* WLAN_FEATURE_11BE_MLO */
@@ -540,6 +540,14 @@ dp_peer_state_cmp(struct dp_peer *peer,
 }
 
 void dp_print_ast_stats(struct dp_soc *soc);
+
+/**
+ * dp_print_peer_hash_stats() - Dump peer hash table occupancy
+ * @soc: Datapath soc handle
+ *
+ * return void
+ */
+void dp_print_peer_hash_stats(struct dp_soc *soc);
 QDF_STATUS dp_rx_peer_map_handler(struct dp_soc *soc, uint16_t peer_id,
 				  uint16_t hw_peer_id, uint8_t vdev_id,
 				  uint8_t *peer_mac_addr, uint16_t ast_hash,
@@ -484,32 +484,26 @@ static inline uint32_t dp_rx_get_le32_split(uint8_t b0, uint8_t b1, uint8_t b2,
 }
 
 /*
- *dp_rx_get_le32() - get little endian 32 bits
- *@b0: byte 0
- *@b1: byte 1
- *@b2: byte 2
- *@b3: byte 3
+ * dp_rx_get_le32() - get little endian 32 bits
+ * @p: source char array, need not be aligned
  *
- *Returns: Integer with little endian 32 bits
+ * Returns: Integer with little endian 32 bits
  */
 static inline uint32_t dp_rx_get_le32(const uint8_t *p)
 {
-	return dp_rx_get_le32_split(p[0], p[1], p[2], p[3]);
+	return qdf_get_unaligned_le32(p);
 }
 
 /*
  * dp_rx_put_le32() - put little endian 32 bits
- * @p: destination char array
+ * @p: destination char array, need not be aligned
  * @v: source 32-bit integer
  *
  * Returns: None
  */
 static inline void dp_rx_put_le32(uint8_t *p, uint32_t v)
 {
-	p[0] = (v) & 0xff;
-	p[1] = (v >> 8) & 0xff;
-	p[2] = (v >> 16) & 0xff;
-	p[3] = (v >> 24) & 0xff;
+	qdf_put_unaligned_le32(v, p);
 }
 
 /* Extract michal mic block of data */
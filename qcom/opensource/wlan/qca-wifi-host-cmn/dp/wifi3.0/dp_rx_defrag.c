@@ -653,6 +653,9 @@ static void dp_rx_defrag_michdr(const struct ieee80211_frame *wh0,
 	hdr[13] = hdr[14] = hdr[15] = 0;	/* reserved */
 }
 
+/* bytes consumed per pass of the unrolled Michael MIC loop */
+#define DP_RX_MIC_STRIDE (4 * sizeof(uint32_t))
+
 /*
  * dp_rx_defrag_mic(): Calculate MIC header
  * @key: Pointer to the key
@@ -670,6 +673,7 @@ static QDF_STATUS dp_rx_defrag_mic(struct dp_soc *soc, const uint8_t *key,
 				   uint16_t data_len, uint8_t mic[])
 {
 	uint8_t hdr[16] = { 0, };
+	uint8_t blk[sizeof(uint32_t)];
 	uint32_t l, r;
 	const uint8_t *data;
 	uint32_t space;
@@ -699,7 +703,24 @@ static QDF_STATUS dp_rx_defrag_mic(struct dp_soc *soc, const uint8_t *key,
 		if (space > data_len)
 			space = data_len;
 
-		/* collect 32-bit blocks from current buffer */
+		/*
+		 * collect 32-bit blocks from current buffer, four at a time
+		 * while there is room so the loop overhead is amortized over
+		 * a 16 byte stride
+		 */
+		while (space >= DP_RX_MIC_STRIDE) {
+			l ^= dp_rx_get_le32(data);
+			dp_rx_michael_block(l, r);
+			l ^= dp_rx_get_le32(data + 4);
+			dp_rx_michael_block(l, r);
+			l ^= dp_rx_get_le32(data + 8);
+			dp_rx_michael_block(l, r);
+			l ^= dp_rx_get_le32(data + 12);
+			dp_rx_michael_block(l, r);
+			data += DP_RX_MIC_STRIDE;
+			space -= DP_RX_MIC_STRIDE;
+			data_len -= DP_RX_MIC_STRIDE;
+		}
 		while (space >= sizeof(uint32_t)) {
 			l ^= dp_rx_get_le32(data);
 			dp_rx_michael_block(l, r);
@@ -725,27 +746,17 @@ static QDF_STATUS dp_rx_defrag_mic(struct dp_soc *soc, const uint8_t *key,
 				sizeof(uint32_t) - space) {
 				return QDF_STATUS_E_DEFRAG_ERROR;
 			}
-			switch (space) {
-			case 1:
-				l ^= dp_rx_get_le32_split(data[0],
-					data_next[0], data_next[1],
-					data_next[2]);
-				data = data_next + 3;
-				space = (qdf_nbuf_len(wbuf) - off) - 3;
-				break;
-			case 2:
-				l ^= dp_rx_get_le32_split(data[0], data[1],
-						    data_next[0], data_next[1]);
-				data = data_next + 2;
-				space = (qdf_nbuf_len(wbuf) - off) - 2;
-				break;
-			case 3:
-				l ^= dp_rx_get_le32_split(data[0], data[1],
-					data[2], data_next[0]);
-				data = data_next + 1;
-				space = (qdf_nbuf_len(wbuf) - off) - 1;
-				break;
-			}
+			/*
+			 * Gather the straddling block into a word on the
+			 * stack instead of walking it byte by byte.
+			 */
+			qdf_mem_copy(blk, data, space);
+			qdf_mem_copy(&blk[space], data_next,
+				     sizeof(uint32_t) - space);
+			l ^= dp_rx_get_le32(blk);
+			data = data_next + (sizeof(uint32_t) - space);
+			space = (qdf_nbuf_len(wbuf) - off) -
+				(sizeof(uint32_t) - space);
 			dp_rx_michael_block(l, r);
 			data_len -= sizeof(uint32_t);
 		} else {
@@ -6403,7 +6403,11 @@ static void dp_print_hist_stats(struct cdp_hist_stats *hstats,
 	if (hist_delay_data) {
 		DP_PRINT_STATS("Min = %u", hstats->min);
 		DP_PRINT_STATS("Max = %u", hstats->max);
-		DP_PRINT_STATS("Avg = %u\n", hstats->avg);
+		DP_PRINT_STATS("Avg = %u", hstats->avg);
+		DP_PRINT_STATS("P50 >= %d P99 >= %d P99.9 >= %d\n",
+			       dp_hist_get_percentile(hstats, 500),
+			       dp_hist_get_percentile(hstats, 990),
+			       dp_hist_get_percentile(hstats, 999));
 	}
 }
 
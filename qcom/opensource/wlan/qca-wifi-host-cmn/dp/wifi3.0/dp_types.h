@@ -119,6 +119,8 @@
 #define MAX_WBM_INT_ERROR_REASONS 5
 
 #define MAX_TX_HW_QUEUES MAX_TCL_DATA_RINGS
+/* Number of locks striped over the peer hash bins, power of 2 */
+#define DP_PEER_HASH_LOCKS 64
 /* Maximum retries for Delba per tid per peer */
 #define DP_MAX_DELBA_RETRY 3
 
@@ -2512,8 +2514,8 @@ struct dp_soc {
 		qdf_dma_mem_context(memctx);
 	} me_buf;
 
-	/* Protect peer hash table */
-	DP_MUTEX_TYPE peer_hash_lock;
+	/* Protect peer hash table, striped by hash bin */
+	DP_MUTEX_TYPE peer_hash_lock[DP_PEER_HASH_LOCKS];
 	/* Protect peer_id_to_objmap */
 	DP_MUTEX_TYPE peer_map_lock;
 
@@ -30,29 +30,59 @@
  * are all of a uniform size. Segments are groups of items, representing the
  * smallest amount of memory that can be dynamically allocated or freed. A pool
  * is simply a collection of segments.
+ *
+ * Optionally, a pool can front its segments with a small per-cpu cache of free
+ * items. Allocations and frees are then served from the local cache, and only
+ * touch the pool lock and the segment list to refill or drain a batch of items
+ * at a time.
  */
 
 #ifndef __QDF_FLEX_MEM_H
 #define __QDF_FLEX_MEM_H
 
+#include "qdf_atomic.h"
+#include "qdf_debugfs.h"
 #include "qdf_list.h"
 #include "qdf_lock.h"
 
 #define QDF_FM_BITMAP uint32_t
 #define QDF_FM_BITMAP_BITS (sizeof(QDF_FM_BITMAP) * 8)
 
+/**
+ * qdf_flex_mem_cache - a per-cpu cache of free items
+ * @lock: spinlock for protecting the cache; only contended when a caller is
+ *	migrated to another cpu in the middle of an operation
+ * @count: the number of free items in @items
+ * @hits: the number of allocations served from the cache
+ * @misses: the number of allocations which had to refill the cache
+ * @items: the cached free items
+ */
+struct qdf_flex_mem_cache {
+	struct qdf_spinlock lock;
+	uint16_t count;
+	uint32_t hits;
+	uint32_t misses;
+	void *items[];
+};
+
 /**
  * qdf_flex_mem_pool - a pool of memory segments
  * @seg_list: the list containing the memory segments
  * @lock: spinlock for protecting internal data structures
  * @reduction_limit: the minimum number of segments to keep during reduction
  * @item_size: the size of the items the pool will allocate
+ * @cache_size: the number of items each per-cpu cache holds, 0 for no cache
+ * @caches: the per-cpu caches, QDF_MAX_AVAILABLE_CPU entries
+ * @contention: the number of times the pool lock was found already taken
  */
 struct qdf_flex_mem_pool {
 	qdf_list_t seg_list;
 	struct qdf_spinlock lock;
 	uint16_t reduction_limit;
 	uint16_t item_size;
+	uint16_t cache_size;
+	void *caches;
+	qdf_atomic_t contention;
 };
 
 /**
@@ -89,6 +119,30 @@ struct qdf_flex_mem_segment {
 		.item_size = (size_of_item), \
 	}
 
+/**
+ * DEFINE_QDF_FLEX_MEM_POOL_CACHED() - define a new flex mem pool with one
+ *	segment, and per-cpu caches of free items in front of it
+ * @name: the name of the pool variable
+ * @size_of_item: size of the items the pool will allocate
+ * @rm_limit: min number of segments to keep during reduction
+ * @size_of_cache: number of free items to keep in each per-cpu cache
+ */
+#define DEFINE_QDF_FLEX_MEM_POOL_CACHED(name, size_of_item, rm_limit, \
+					size_of_cache) \
+	struct qdf_flex_mem_pool name; \
+	uint8_t __ ## name ## _head_bytes[QDF_FM_BITMAP_BITS * (size_of_item)];\
+	struct qdf_flex_mem_segment __ ## name ## _head = { \
+		.node = QDF_LIST_NODE_INIT_SINGLE( \
+			QDF_LIST_ANCHOR(name.seg_list)), \
+		.bytes = __ ## name ## _head_bytes, \
+	}; \
+	struct qdf_flex_mem_pool name = { \
+		.seg_list = QDF_LIST_INIT_SINGLE(__ ## name ## _head.node), \
+		.reduction_limit = (rm_limit), \
+		.item_size = (size_of_item), \
+		.cache_size = (size_of_cache), \
+	}
+
 /**
  * qdf_flex_mem_init() - initialize a qdf_flex_mem_pool
  * @pool: the pool to initialize
@@ -101,6 +155,8 @@ void qdf_flex_mem_init(struct qdf_flex_mem_pool *pool);
  * qdf_flex_mem_deinit() - deinitialize a qdf_flex_mem_pool
  * @pool: the pool to deinitialize
  *
+ * Any items held in the per-cpu caches are returned to the pool first.
+ *
  * Return: None
  */
 void qdf_flex_mem_deinit(struct qdf_flex_mem_pool *pool);
@@ -112,7 +168,9 @@ void qdf_flex_mem_deinit(struct qdf_flex_mem_pool *pool);
  * This function returns any unused item from any existing segment in the pool.
  * If there are no unused items in the pool, a new segment is dynamically
  * allocated to service the request. The size of the allocated memory is the
- * size originally used to create the pool.
+ * size originally used to create the pool. For cached pools, the item is taken
+ * from the local cpu cache, which is refilled with a batch of items from the
+ * segments when empty.
  *
  * Return: Point to newly allocated memory, NULL on failure
  */
@@ -125,10 +183,23 @@ void *qdf_flex_mem_alloc(struct qdf_flex_mem_pool *pool);
  *
  * This function marks the item corresponding to @ptr as unused. If that item
  * was the last used item in the segment it belongs to, and the segment was
- * dynamically allocated, the segment will be freed.
+ * dynamically allocated, the segment will be freed. For cached pools, the item
+ * is put in the local cpu cache, and half of the cache is returned to the
+ * segments when it is full.
  *
  * Return: None
  */
 void qdf_flex_mem_free(struct qdf_flex_mem_pool *pool, void *ptr);
 
+/**
+ * qdf_flex_mem_stats_show() - print the cache and lock statistics of a pool
+ * @file: debugfs file handle passed in fops->show() function
+ * @arg: the struct qdf_flex_mem_pool to print the statistics of
+ *
+ * Meant to be used as the show callback of a struct qdf_debugfs_fops.
+ *
+ * Return: QDF_STATUS_SUCCESS
+ */
+QDF_STATUS qdf_flex_mem_stats_show(qdf_debugfs_file_t file, void *arg);
+
 #endif /* __QDF_FLEX_MEM_H */
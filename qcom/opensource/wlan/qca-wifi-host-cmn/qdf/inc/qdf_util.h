@@ -633,6 +633,23 @@ static inline uint8_t *qdf_get_u32(uint8_t *ptr, uint32_t *value)
  */
 #define qdf_be64_to_cpu(x)                   __qdf_be64_to_cpu(x)
 
+/**
+ * qdf_get_unaligned_le32 - Load a little-endian 32-bit value from a
+ * possibly unaligned address, in CPU byte order
+ *
+ * @p: pointer to the first byte of the value
+ */
+#define qdf_get_unaligned_le32(p)            __qdf_get_unaligned_le32(p)
+
+/**
+ * qdf_put_unaligned_le32 - Store a 32-bit value in little-endian byte
+ * order to a possibly unaligned address
+ *
+ * @v: value to be stored
+ * @p: pointer to the first byte of the destination
+ */
+#define qdf_put_unaligned_le32(v, p)         __qdf_put_unaligned_le32(v, p)
+
 /**
  * qdf_function - replace with the name of the current function
  */
@@ -37,6 +37,7 @@
 
 #include <qdf_types.h>
 #include <asm/byteorder.h>
+#include <asm/unaligned.h>
 
 #if LINUX_VERSION_CODE  <= KERNEL_VERSION(3, 3, 8)
 #include <asm/system.h>
@@ -257,6 +258,9 @@ static inline bool __qdf_is_macaddr_equal(struct qdf_mac_addr *mac_addr1,
 #define __qdf_be32_to_cpu be32_to_cpu
 #define __qdf_be64_to_cpu be64_to_cpu
 
+#define __qdf_get_unaligned_le32 get_unaligned_le32
+#define __qdf_put_unaligned_le32 put_unaligned_le32
+
 /**
  * @brief memory barriers.
  */
@@ -44,6 +44,61 @@ qdf_flex_mem_seg_alloc(struct qdf_flex_mem_pool *pool)
 	return seg;
 }
 
+static inline size_t qdf_flex_mem_cache_stride(struct qdf_flex_mem_pool *pool)
+{
+	return sizeof(struct qdf_flex_mem_cache) +
+		pool->cache_size * sizeof(void *);
+}
+
+static inline struct qdf_flex_mem_cache *
+qdf_flex_mem_get_cache(struct qdf_flex_mem_pool *pool, int cpu)
+{
+	return (struct qdf_flex_mem_cache *)
+		((uint8_t *)pool->caches + cpu * qdf_flex_mem_cache_stride(pool));
+}
+
+static void qdf_flex_mem_caches_init(struct qdf_flex_mem_pool *pool)
+{
+	int cpu;
+
+	qdf_atomic_init(&pool->contention);
+
+	if (!pool->cache_size)
+		return;
+
+	pool->caches = qdf_mem_malloc(QDF_MAX_AVAILABLE_CPU *
+				      qdf_flex_mem_cache_stride(pool));
+	if (!pool->caches) {
+		/* fall back to serving every request from the segments */
+		pool->cache_size = 0;
+		return;
+	}
+
+	for (cpu = 0; cpu < QDF_MAX_AVAILABLE_CPU; cpu++)
+		qdf_spinlock_create(&qdf_flex_mem_get_cache(pool, cpu)->lock);
+}
+
+static void __qdf_flex_mem_free(struct qdf_flex_mem_pool *pool, void *ptr);
+
+static void qdf_flex_mem_caches_deinit(struct qdf_flex_mem_pool *pool)
+{
+	struct qdf_flex_mem_cache *cache;
+	int cpu;
+
+	if (!pool->caches)
+		return;
+
+	for (cpu = 0; cpu < QDF_MAX_AVAILABLE_CPU; cpu++) {
+		cache = qdf_flex_mem_get_cache(pool, cpu);
+		while (cache->count)
+			__qdf_flex_mem_free(pool, cache->items[--cache->count]);
+		qdf_spinlock_destroy(&cache->lock);
+	}
+
+	qdf_mem_free(pool->caches);
+	pool->caches = NULL;
+}
+
 void qdf_flex_mem_init(struct qdf_flex_mem_pool *pool)
 {
 	int i;
@@ -52,6 +107,8 @@ void qdf_flex_mem_init(struct qdf_flex_mem_pool *pool)
 
 	for (i = 0; i < pool->reduction_limit; i++)
 		qdf_flex_mem_seg_alloc(pool);
+
+	qdf_flex_mem_caches_init(pool);
 }
 qdf_export_symbol(qdf_flex_mem_init);
 
@@ -59,6 +116,7 @@ void qdf_flex_mem_deinit(struct qdf_flex_mem_pool *pool)
 {
 	struct qdf_flex_mem_segment *seg, *next;
 
+	qdf_flex_mem_caches_deinit(pool);
 	qdf_spinlock_destroy(&pool->lock);
 
 	qdf_list_for_each_del(&pool->seg_list, seg, next, node) {
@@ -73,6 +131,15 @@ void qdf_flex_mem_deinit(struct qdf_flex_mem_pool *pool)
 }
 qdf_export_symbol(qdf_flex_mem_deinit);
 
+static void qdf_flex_mem_lock(struct qdf_flex_mem_pool *pool)
+{
+	if (qdf_spin_trylock_bh(&pool->lock))
+		return;
+
+	qdf_atomic_inc(&pool->contention);
+	qdf_spin_lock_bh(&pool->lock);
+}
+
 static void *__qdf_flex_mem_alloc(struct qdf_flex_mem_pool *pool)
 {
 	struct qdf_flex_mem_segment *seg;
@@ -89,7 +156,6 @@ static void *__qdf_flex_mem_alloc(struct qdf_flex_mem_pool *pool)
 
 		seg->used_bitmap ^= (QDF_FM_BITMAP)1 << index;
 		ptr = &seg->bytes[index * pool->item_size];
-		qdf_mem_zero(ptr, pool->item_size);
 
 		return ptr;
 	}
@@ -103,6 +169,36 @@ static void *__qdf_flex_mem_alloc(struct qdf_flex_mem_pool *pool)
 	return seg->bytes;
 }
 
+static void *qdf_flex_mem_cache_alloc(struct qdf_flex_mem_pool *pool)
+{
+	struct qdf_flex_mem_cache *cache;
+	void *ptr = NULL;
+
+	cache = qdf_flex_mem_get_cache(pool, qdf_get_cpu());
+
+	qdf_spin_lock_bh(&cache->lock);
+	if (cache->count) {
+		cache->hits++;
+	} else {
+		cache->misses++;
+
+		/* refill half the cache, leaving room for local frees */
+		qdf_flex_mem_lock(pool);
+		do {
+			ptr = __qdf_flex_mem_alloc(pool);
+			if (!ptr)
+				break;
+			cache->items[cache->count++] = ptr;
+		} while (cache->count < (pool->cache_size + 1) / 2);
+		qdf_spin_unlock_bh(&pool->lock);
+	}
+
+	ptr = cache->count ? cache->items[--cache->count] : NULL;
+	qdf_spin_unlock_bh(&cache->lock);
+
+	return ptr;
+}
+
 void *qdf_flex_mem_alloc(struct qdf_flex_mem_pool *pool)
 {
 	void *ptr;
@@ -111,9 +207,16 @@ void *qdf_flex_mem_alloc(struct qdf_flex_mem_pool *pool)
 	if (!pool)
 		return NULL;
 
-	qdf_spin_lock_bh(&pool->lock);
-	ptr = __qdf_flex_mem_alloc(pool);
-	qdf_spin_unlock_bh(&pool->lock);
+	if (pool->cache_size) {
+		ptr = qdf_flex_mem_cache_alloc(pool);
+	} else {
+		qdf_flex_mem_lock(pool);
+		ptr = __qdf_flex_mem_alloc(pool);
+		qdf_spin_unlock_bh(&pool->lock);
+	}
+
+	if (ptr)
+		qdf_mem_zero(ptr, pool->item_size);
 
 	return ptr;
 }
@@ -159,6 +262,25 @@ static void __qdf_flex_mem_free(struct qdf_flex_mem_pool *pool, void *ptr)
 	QDF_DEBUG_PANIC("Failed to find pointer in segment pool");
 }
 
+static void qdf_flex_mem_cache_free(struct qdf_flex_mem_pool *pool, void *ptr)
+{
+	struct qdf_flex_mem_cache *cache;
+
+	cache = qdf_flex_mem_get_cache(pool, qdf_get_cpu());
+
+	qdf_spin_lock_bh(&cache->lock);
+	if (cache->count == pool->cache_size) {
+		/* drain half the cache, leaving items for local allocs */
+		qdf_flex_mem_lock(pool);
+		while (cache->count > pool->cache_size / 2)
+			__qdf_flex_mem_free(pool, cache->items[--cache->count]);
+		qdf_spin_unlock_bh(&pool->lock);
+	}
+
+	cache->items[cache->count++] = ptr;
+	qdf_spin_unlock_bh(&cache->lock);
+}
+
 void qdf_flex_mem_free(struct qdf_flex_mem_pool *pool, void *ptr)
 {
 	QDF_BUG(pool);
@@ -169,9 +291,41 @@ void qdf_flex_mem_free(struct qdf_flex_mem_pool *pool, void *ptr)
 	if (!ptr)
 		return;
 
-	qdf_spin_lock_bh(&pool->lock);
+	if (pool->cache_size) {
+		qdf_flex_mem_cache_free(pool, ptr);
+		return;
+	}
+
+	qdf_flex_mem_lock(pool);
 	__qdf_flex_mem_free(pool, ptr);
 	qdf_spin_unlock_bh(&pool->lock);
 }
 qdf_export_symbol(qdf_flex_mem_free);
 
+QDF_STATUS qdf_flex_mem_stats_show(qdf_debugfs_file_t file, void *arg)
+{
+	struct qdf_flex_mem_pool *pool = arg;
+	struct qdf_flex_mem_cache *cache;
+	int cpu;
+
+	qdf_debugfs_printf(file, "item size: %u, segments: %u, contention: %d\n",
+			   pool->item_size, qdf_list_size(&pool->seg_list),
+			   qdf_atomic_read(&pool->contention));
+
+	if (!pool->cache_size)
+		return QDF_STATUS_SUCCESS;
+
+	qdf_debugfs_printf(file, "cpu\tcached\thits\tmisses\n");
+	for (cpu = 0; cpu < QDF_MAX_AVAILABLE_CPU; cpu++) {
+		cache = qdf_flex_mem_get_cache(pool, cpu);
+		if (!cache->hits && !cache->misses)
+			continue;
+
+		qdf_debugfs_printf(file, "%d\t%u\t%u\t%u\n", cpu, cache->count,
+				   cache->hits, cache->misses);
+	}
+
+	return QDF_STATUS_SUCCESS;
+}
+qdf_export_symbol(qdf_flex_mem_stats_show);
+
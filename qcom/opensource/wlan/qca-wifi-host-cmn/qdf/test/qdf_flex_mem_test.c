@@ -0,0 +1,82 @@
+/*
+ * Copyright (c) 2026 Qualcomm Innovation Center, Inc. All rights reserved.
+ *
+ * Permission to use, copy, modify, and/or distribute this software for
+ * any purpose with or without fee is hereby granted, provided that the
+ * above copyright notice and this permission notice appear in all
+ * copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL
+ * WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE
+ * AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL
+ * DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR
+ * PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER
+ * TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR
+ * PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#include "qdf_flex_mem.h"
+#include "qdf_flex_mem_test.h"
+#include "qdf_mem.h"
+#include "qdf_trace.h"
+
+#define QDF_FM_TEST_ITEM_SIZE 24
+#define QDF_FM_TEST_CACHE_SIZE 8
+#define QDF_FM_TEST_ITEMS (QDF_FM_BITMAP_BITS * 3)
+
+DEFINE_QDF_FLEX_MEM_POOL(qdf_fm_test_pool, QDF_FM_TEST_ITEM_SIZE, 0);
+DEFINE_QDF_FLEX_MEM_POOL_CACHED(qdf_fm_test_cached_pool,
+				QDF_FM_TEST_ITEM_SIZE, 0,
+				QDF_FM_TEST_CACHE_SIZE);
+
+static uint32_t qdf_flex_mem_test_pool(struct qdf_flex_mem_pool *pool)
+{
+	uint8_t *items[QDF_FM_TEST_ITEMS];
+	uint8_t *ptr;
+	int i, j;
+
+	qdf_flex_mem_init(pool);
+
+	/* allocate across multiple segments, dirtying every item */
+	for (i = 0; i < QDF_FM_TEST_ITEMS; i++) {
+		items[i] = qdf_flex_mem_alloc(pool);
+		QDF_BUG(items[i]);
+		for (j = 0; j < QDF_FM_TEST_ITEM_SIZE; j++)
+			QDF_BUG(!items[i][j]);
+		qdf_mem_set(items[i], QDF_FM_TEST_ITEM_SIZE, 0xa5);
+	}
+
+	for (i = 0; i < QDF_FM_TEST_ITEMS; i++)
+		for (j = i + 1; j < QDF_FM_TEST_ITEMS; j++)
+			QDF_BUG(items[i] != items[j]);
+
+	/* interleave frees and allocs, items must come back zeroed */
+	for (i = 0; i < QDF_FM_TEST_ITEMS; i += 2) {
+		qdf_flex_mem_free(pool, items[i]);
+		ptr = qdf_flex_mem_alloc(pool);
+		QDF_BUG(ptr);
+		for (j = 0; j < QDF_FM_TEST_ITEM_SIZE; j++)
+			QDF_BUG(!ptr[j]);
+		items[i] = ptr;
+	}
+
+	for (i = 0; i < QDF_FM_TEST_ITEMS; i++)
+		qdf_flex_mem_free(pool, items[i]);
+
+	/* deinit drains the caches; every segment must be unused by then */
+	qdf_flex_mem_deinit(pool);
+	QDF_BUG(qdf_list_empty(&pool->seg_list));
+
+	return 0;
+}
+
+uint32_t qdf_flex_mem_unit_test(void)
+{
+	uint32_t errors = 0;
+
+	errors += qdf_flex_mem_test_pool(&qdf_fm_test_pool);
+	errors += qdf_flex_mem_test_pool(&qdf_fm_test_cached_pool);
+
+	return errors;
+}
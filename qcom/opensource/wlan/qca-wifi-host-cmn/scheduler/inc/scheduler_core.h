@@ -30,6 +30,13 @@
 #ifndef WLAN_SCHED_REDUCTION_LIMIT
 #define WLAN_SCHED_REDUCTION_LIMIT 32
 #endif
+#ifndef WLAN_SCHED_FLEX_MEM_CACHE_SIZE
+#define WLAN_SCHED_FLEX_MEM_CACHE_SIZE 16
+#endif
+#ifndef SCHEDULER_MQ_BUDGET
+#define SCHEDULER_MQ_BUDGET 8
+#endif
+#define SCHED_LATENCY_BUCKETS 6
 #define SCHEDULER_NUMBER_OF_MSG_QUEUE 6
 #define SCHEDULER_WRAPPER_MAX_FAIL_COUNT (SCHEDULER_CORE_MAX_MESSAGES * 3)
 #define SCHEDULER_WATCHDOG_TIMEOUT (10 * 1000) /* 10s */
@@ -70,11 +77,19 @@
  * @mq_lock: message queue lock
  * @mq_list: message queue list
  * @qid: queue id
+ * @budget: max messages processed from this queue before the lower priority
+ *	queues get a turn
+ * @latency_hist: histogram of the time messages spent queued, bucketed by
+ *	<100us, <1ms, <10ms, <100ms, <1s and >=1s
  */
 struct scheduler_mq_type {
 	qdf_spinlock_t mq_lock;
 	qdf_list_t mq_list;
 	QDF_MODULE_ID qid;
+	uint32_t budget;
+#ifdef WLAN_SCHED_HISTORY_SIZE
+	uint32_t latency_hist[SCHED_LATENCY_BUCKETS];
+#endif
 };
 
 /**
@@ -216,6 +231,20 @@ void scheduler_mq_put_front(struct scheduler_mq_type *msg_q,
  */
 struct scheduler_msg *scheduler_mq_get(struct scheduler_mq_type *msg_q);
 
+/**
+ * scheduler_mq_get_batch() - get several messages from message queue
+ * @msg_q: Pointer to the message queue
+ * @batch: list the messages are moved to, in queue order
+ * @budget: max number of messages to get
+ *
+ * This function moves up to @budget messages from the front of the given
+ * message queue to @batch, taking the queue lock only once.
+ *
+ * Return: number of messages moved
+ */
+uint32_t scheduler_mq_get_batch(struct scheduler_mq_type *msg_q,
+				qdf_list_t *batch, uint32_t budget);
+
 /**
  * scheduler_queues_init() - to initialize all the modules' queues
  * @sched_ctx: pointer to scheduler context
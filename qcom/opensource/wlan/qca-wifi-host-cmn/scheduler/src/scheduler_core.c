@@ -24,8 +24,19 @@
 static struct scheduler_ctx g_sched_ctx;
 static struct scheduler_ctx *gp_sched_ctx;
 
-DEFINE_QDF_FLEX_MEM_POOL(sched_pool, sizeof(struct scheduler_msg),
-			 WLAN_SCHED_REDUCTION_LIMIT);
+DEFINE_QDF_FLEX_MEM_POOL_CACHED(sched_pool, sizeof(struct scheduler_msg),
+				WLAN_SCHED_REDUCTION_LIMIT,
+				WLAN_SCHED_FLEX_MEM_CACHE_SIZE);
+
+#define SCHED_POOL_DEBUGFS_FILE "sched_pool"
+#define SCHED_POOL_DEBUGFS_PERM (QDF_FILE_USR_READ | QDF_FILE_GRP_READ)
+
+static struct qdf_debugfs_fops sched_pool_fops = {
+	.show = qdf_flex_mem_stats_show,
+	.priv = &sched_pool,
+};
+
+static qdf_dentry_t sched_pool_dentry;
 
 #ifdef WLAN_SCHED_HISTORY_SIZE
 
@@ -71,7 +82,70 @@ static void sched_history_queue(struct scheduler_mq_type *queue,
 	msg->queued_at_us = qdf_get_log_timestamp_usecs();
 }
 
-static void sched_history_start(struct scheduler_msg *msg)
+static const uint32_t sched_latency_bounds_us[SCHED_LATENCY_BUCKETS - 1] = {
+	100, 1000, 10000, 100000, 1000000
+};
+
+static void sched_latency_update(struct scheduler_mq_type *queue,
+				 uint32_t queue_duration_us)
+{
+	int i;
+
+	for (i = 0; i < SCHED_LATENCY_BUCKETS - 1; i++) {
+		if (queue_duration_us < sched_latency_bounds_us[i])
+			break;
+	}
+
+	queue->latency_hist[i]++;
+}
+
+static QDF_STATUS sched_latency_show(qdf_debugfs_file_t file, void *arg)
+{
+	struct scheduler_ctx *sched_ctx = arg;
+	struct scheduler_mq_type *queue;
+	int i;
+
+	qdf_debugfs_printf(file, "qid\tqueued\t<100us\t<1ms\t<10ms\t<100ms\t<1s\t>=1s\n");
+	for (i = 0; i < SCHEDULER_NUMBER_OF_MSG_QUEUE; i++) {
+		queue = &sched_ctx->queue_ctx.sch_msg_q[i];
+		qdf_debugfs_printf(file, "%d\t%u\t%u\t%u\t%u\t%u\t%u\t%u\n",
+				   queue->qid, qdf_list_size(&queue->mq_list),
+				   queue->latency_hist[0],
+				   queue->latency_hist[1],
+				   queue->latency_hist[2],
+				   queue->latency_hist[3],
+				   queue->latency_hist[4],
+				   queue->latency_hist[5]);
+	}
+
+	return QDF_STATUS_SUCCESS;
+}
+
+#define SCHED_LATENCY_DEBUGFS_FILE "sched_latency"
+
+static struct qdf_debugfs_fops sched_latency_fops = {
+	.show = sched_latency_show,
+	.priv = &g_sched_ctx,
+};
+
+static qdf_dentry_t sched_latency_dentry;
+
+static void sched_latency_debugfs_init(void)
+{
+	sched_latency_dentry =
+		qdf_debugfs_create_file(SCHED_LATENCY_DEBUGFS_FILE,
+					SCHED_POOL_DEBUGFS_PERM, NULL,
+					&sched_latency_fops);
+}
+
+static void sched_latency_debugfs_deinit(void)
+{
+	qdf_debugfs_remove_file(sched_latency_dentry);
+	sched_latency_dentry = NULL;
+}
+
+static void sched_history_start(struct scheduler_mq_type *queue,
+				struct scheduler_msg *msg)
 {
 	uint64_t started_at_us = qdf_get_log_timestamp_usecs();
 	struct sched_history_item hist = {
@@ -84,6 +158,7 @@ static void sched_history_start(struct scheduler_msg *msg)
 	};
 
 	sched_history[sched_history_index] = hist;
+	sched_latency_update(queue, hist.queue_duration_us);
 }
 
 static void sched_history_stop(void)
@@ -140,8 +215,11 @@ void sched_history_print(void)
 
 static inline void sched_history_queue(struct scheduler_mq_type *queue,
 				       struct scheduler_msg *msg) { }
-static inline void sched_history_start(struct scheduler_msg *msg) { }
+static inline void sched_history_start(struct scheduler_mq_type *queue,
+				       struct scheduler_msg *msg) { }
 static inline void sched_history_stop(void) { }
+static inline void sched_latency_debugfs_init(void) { }
+static inline void sched_latency_debugfs_deinit(void) { }
 void sched_history_print(void) { }
 
 #endif /* WLAN_SCHED_HISTORY_SIZE */
@@ -149,6 +227,10 @@ void sched_history_print(void) { }
 QDF_STATUS scheduler_create_ctx(void)
 {
 	qdf_flex_mem_init(&sched_pool);
+	sched_pool_dentry = qdf_debugfs_create_file(SCHED_POOL_DEBUGFS_FILE,
+						    SCHED_POOL_DEBUGFS_PERM,
+						    NULL, &sched_pool_fops);
+	sched_latency_debugfs_init();
 	gp_sched_ctx = &g_sched_ctx;
 
 	return QDF_STATUS_SUCCESS;
@@ -157,6 +239,9 @@ QDF_STATUS scheduler_create_ctx(void)
 QDF_STATUS scheduler_destroy_ctx(void)
 {
 	gp_sched_ctx = NULL;
+	sched_latency_debugfs_deinit();
+	qdf_debugfs_remove_file(sched_pool_dentry);
+	sched_pool_dentry = NULL;
 	qdf_flex_mem_deinit(&sched_pool);
 
 	return QDF_STATUS_SUCCESS;
@@ -175,6 +260,7 @@ static QDF_STATUS scheduler_mq_init(struct scheduler_mq_type *msg_q)
 
 	qdf_spinlock_create(&msg_q->mq_lock);
 	qdf_list_create(&msg_q->mq_list, SCHEDULER_CORE_MAX_MESSAGES);
+	msg_q->budget = SCHEDULER_MQ_BUDGET;
 
 	sched_exit();
 
@@ -281,6 +367,40 @@ struct scheduler_msg *scheduler_mq_get(struct scheduler_mq_type *msg_q)
 	return qdf_container_of(node, struct scheduler_msg, node);
 }
 
+uint32_t scheduler_mq_get_batch(struct scheduler_mq_type *msg_q,
+				qdf_list_t *batch, uint32_t budget)
+{
+	qdf_list_node_t *node;
+	uint32_t count = 0;
+
+	qdf_spin_lock_irqsave(&msg_q->mq_lock);
+	while (count < budget &&
+	       QDF_IS_STATUS_SUCCESS(qdf_list_remove_front(&msg_q->mq_list,
+							   &node))) {
+		qdf_list_insert_back(batch, node);
+		count++;
+	}
+	qdf_spin_unlock_irqrestore(&msg_q->mq_lock);
+
+	return count;
+}
+
+/**
+ * scheduler_mq_requeue_batch() - put unprocessed messages back in the queue
+ * @msg_q: Pointer to the message queue
+ * @batch: messages taken by scheduler_mq_get_batch() and not yet processed
+ *
+ * Return: none
+ */
+static void scheduler_mq_requeue_batch(struct scheduler_mq_type *msg_q,
+				       qdf_list_t *batch)
+{
+	qdf_spin_lock_irqsave(&msg_q->mq_lock);
+	qdf_list_join(batch, &msg_q->mq_list);
+	qdf_list_join(&msg_q->mq_list, batch);
+	qdf_spin_unlock_irqrestore(&msg_q->mq_lock);
+}
+
 QDF_STATUS scheduler_queues_deinit(struct scheduler_ctx *sched_ctx)
 {
 	return scheduler_all_queues_deinit(sched_ctx);
@@ -348,68 +468,115 @@ void scheduler_core_msg_free(struct scheduler_msg *msg)
 	qdf_atomic_dec(&__sched_queue_depth);
 }
 
-static void scheduler_thread_process_queues(struct scheduler_ctx *sch_ctx,
-					    bool *shutdown)
+static bool scheduler_thread_check_shutdown(struct scheduler_ctx *sch_ctx)
 {
-	int i;
-	QDF_STATUS status;
-	struct scheduler_msg *msg;
+	if (!qdf_atomic_test_bit(MC_SHUTDOWN_EVENT_MASK,
+				 &sch_ctx->sch_event_flag))
+		return false;
 
-	if (!sch_ctx) {
-		QDF_DEBUG_PANIC("sch_ctx is null");
-		return;
+	sched_debug("scheduler thread signaled to shutdown");
+
+	/* Check for any Suspend Indication */
+	if (qdf_atomic_test_and_clear_bit(MC_SUSPEND_EVENT_MASK,
+					  &sch_ctx->sch_event_flag)) {
+		/* Unblock anyone waiting on suspend */
+		if (gp_sched_ctx->hdd_callback)
+			gp_sched_ctx->hdd_callback();
 	}
 
-	/* start with highest priority queue : timer queue at index 0 */
-	i = 0;
-	while (i < SCHEDULER_NUMBER_OF_MSG_QUEUE) {
-		/* Check if MC needs to shutdown */
-		if (qdf_atomic_test_bit(MC_SHUTDOWN_EVENT_MASK,
-					&sch_ctx->sch_event_flag)) {
-			sched_debug("scheduler thread signaled to shutdown");
-			*shutdown = true;
+	return true;
+}
 
-			/* Check for any Suspend Indication */
-			if (qdf_atomic_test_and_clear_bit(MC_SUSPEND_EVENT_MASK,
-						&sch_ctx->sch_event_flag)) {
-				/* Unblock anyone waiting on suspend */
-				if (gp_sched_ctx->hdd_callback)
-					gp_sched_ctx->hdd_callback();
-			}
+/**
+ * scheduler_thread_process_queue() - process a batch of messages from a queue
+ * @sch_ctx: scheduler context
+ * @i: index of the queue to process
+ * @shutdown: set to true if the scheduler thread was signaled to shutdown
+ *
+ * Up to the queue's budget of messages are taken from the queue under a single
+ * lock acquisition and processed in order. On shutdown, the messages not yet
+ * processed are put back at the front of the queue so they get flushed.
+ *
+ * Return: number of messages taken from the queue
+ */
+static uint32_t scheduler_thread_process_queue(struct scheduler_ctx *sch_ctx,
+					       int i, bool *shutdown)
+{
+	struct scheduler_mq_type *mq = &sch_ctx->queue_ctx.sch_msg_q[i];
+	qdf_list_t batch;
+	qdf_list_node_t *node;
+	struct scheduler_msg *msg;
+	uint32_t count;
+	QDF_STATUS status;
 
-			break;
-		}
+	qdf_list_create(&batch, mq->budget);
+	count = scheduler_mq_get_batch(mq, &batch, mq->budget);
 
-		msg = scheduler_mq_get(&sch_ctx->queue_ctx.sch_msg_q[i]);
-		if (!msg) {
-			/* check next queue */
-			i++;
+	while (QDF_IS_STATUS_SUCCESS(qdf_list_remove_front(&batch, &node))) {
+		msg = qdf_container_of(node, struct scheduler_msg, node);
+
+		if (!sch_ctx->queue_ctx.scheduler_msg_process_fn[i])
 			continue;
-		}
 
-		if (sch_ctx->queue_ctx.scheduler_msg_process_fn[i]) {
-			sch_ctx->watchdog_msg_type = msg->type;
-			sch_ctx->watchdog_callback = msg->callback;
+		sch_ctx->watchdog_msg_type = msg->type;
+		sch_ctx->watchdog_callback = msg->callback;
+
+		sched_history_start(mq, msg);
+		qdf_timer_start(&sch_ctx->watchdog_timer, sch_ctx->timeout);
+		status = sch_ctx->queue_ctx.scheduler_msg_process_fn[i](msg);
+		qdf_timer_stop(&sch_ctx->watchdog_timer);
+		sched_history_stop();
 
-			sched_history_start(msg);
-			qdf_timer_start(&sch_ctx->watchdog_timer,
-					sch_ctx->timeout);
-			status = sch_ctx->queue_ctx.
-					scheduler_msg_process_fn[i](msg);
-			qdf_timer_stop(&sch_ctx->watchdog_timer);
-			sched_history_stop();
+		if (QDF_IS_STATUS_ERROR(status))
+			sched_err("Failed processing Qid[%d] message", mq->qid);
 
-			if (QDF_IS_STATUS_ERROR(status))
-				sched_err("Failed processing Qid[%d] message",
-					  sch_ctx->queue_ctx.sch_msg_q[i].qid);
+		scheduler_core_msg_free(msg);
 
-			scheduler_core_msg_free(msg);
+		if (scheduler_thread_check_shutdown(sch_ctx)) {
+			*shutdown = true;
+			break;
 		}
+	}
+
+	if (!qdf_list_empty(&batch))
+		scheduler_mq_requeue_batch(mq, &batch);
+	qdf_list_destroy(&batch);
+
+	return count;
+}
+
+static void scheduler_thread_process_queues(struct scheduler_ctx *sch_ctx,
+					    bool *shutdown)
+{
+	uint32_t processed;
+	int i;
 
-		/* start again with highest priority queue at index 0 */
-		i = 0;
+	if (!sch_ctx) {
+		QDF_DEBUG_PANIC("sch_ctx is null");
+		return;
 	}
 
+	/*
+	 * Visit the queues in priority order, starting with the timer queue at
+	 * index 0, and let each of them run up to its budget of messages per
+	 * pass. A busy queue, such as beacon ingest during a roam storm, can
+	 * then only delay the other queues by one budget rather than starve
+	 * them until it drains. Passes repeat until all the queues are empty.
+	 */
+	do {
+		processed = 0;
+		for (i = 0; i < SCHEDULER_NUMBER_OF_MSG_QUEUE; i++) {
+			/* Check if MC needs to shutdown */
+			if (scheduler_thread_check_shutdown(sch_ctx))
+				*shutdown = true;
+			if (*shutdown)
+				return;
+
+			processed += scheduler_thread_process_queue(sch_ctx, i,
+								    shutdown);
+		}
+	} while (processed);
+
 	/* Check for any Suspend Indication */
 	if (qdf_atomic_test_and_clear_bit(MC_SUSPEND_EVENT_MASK,
 			&sch_ctx->sch_event_flag)) {
@@ -360,17 +360,17 @@ static void scm_scan_entry_put_ref(struct scan_dbs *scan_db,
 }
 
 /**
- * scm_scan_entry_del() - API to delete scan node
+ * __scm_scan_entry_del() - API to delete scan node
  * @scan_db: data base
  * @scan_node: node to be deleted
  *
- * Call must be protected by scan_db->scan_db_lock
+ * Call must be protected by scan_db->scan_db_lock. Does not record the
+ * removal in scan_db->del_generation, use when the node is being replaced.
  *
  * Return: void
  */
-
-static void scm_scan_entry_del(struct scan_dbs *scan_db,
-			       struct scan_cache_node *scan_node)
+static void __scm_scan_entry_del(struct scan_dbs *scan_db,
+				 struct scan_cache_node *scan_node)
 {
 	if (!scan_node) {
 		scm_err("scan node is NULL");
@@ -391,6 +391,24 @@ static void scm_scan_entry_del(struct scan_dbs *scan_db,
 	scm_scan_entry_put_ref(scan_db, scan_node, false);
 }
 
+/**
+ * scm_scan_entry_del() - API to delete scan node
+ * @scan_db: data base
+ * @scan_node: node to be deleted
+ *
+ * Call must be protected by scan_db->scan_db_lock
+ *
+ * Return: void
+ */
+static void scm_scan_entry_del(struct scan_dbs *scan_db,
+			       struct scan_cache_node *scan_node)
+{
+	if (scan_node && scan_node->cookie == SCAN_NODE_ACTIVE_COOKIE)
+		scan_db->del_generation = ++scan_db->generation;
+
+	__scm_scan_entry_del(scan_db, scan_node);
+}
+
 /**
  * scm_add_scan_node() - API to add scan node
  * @scan_db: data base
@@ -413,6 +431,9 @@ static void scm_add_scan_node(struct scan_dbs *scan_db,
 
 	qdf_atomic_init(&scan_node->ref_cnt);
 	scan_node->cookie = SCAN_NODE_ACTIVE_COOKIE;
+	scan_node->generation = ++scan_db->generation;
+	scan_node->add_generation = dup_node ? dup_node->add_generation :
+					       scan_node->generation;
 	scm_scan_entry_get_ref(scan_node);
 	if (!dup_node)
 		qdf_list_insert_back(&scan_db->scan_hash_tbl[hash_idx],
@@ -1086,7 +1107,7 @@ static QDF_STATUS scm_add_update_entry(struct wlan_objmgr_psoc *psoc,
 
 	if (is_dup_found) {
 		/* release ref taken for dup node and delete it */
-		scm_scan_entry_del(scan_db, dup_node);
+		__scm_scan_entry_del(scan_db, dup_node);
 		scm_scan_entry_put_ref(scan_db, dup_node, false);
 	}
 	qdf_spin_unlock_bh(&scan_db->scan_db_lock);
@@ -1411,7 +1432,7 @@ QDF_STATUS scm_handle_bcn_probe(struct scheduler_msg *msg)
  * @filter: filter to be applied
  * @scan_list: scan list to which entry is added
  *
- * Return: QDF_STATUS
+ * Return: QDF_STATUS_E_NOENT if the entry did not pass the filter
  */
 static QDF_STATUS
 scm_scan_apply_filter_get_entry(struct wlan_objmgr_psoc *psoc,
@@ -1430,7 +1451,7 @@ scm_scan_apply_filter_get_entry(struct wlan_objmgr_psoc *psoc,
 					filter, &security);
 
 	if (!match)
-		return QDF_STATUS_SUCCESS;
+		return QDF_STATUS_E_NOENT;
 
 	scan_node = qdf_mem_malloc_atomic(sizeof(*scan_node));
 	if (!scan_node)
@@ -1457,17 +1478,22 @@ scm_scan_apply_filter_get_entry(struct wlan_objmgr_psoc *psoc,
  * @psoc: psoc ptr
  * @scan_db: scan db
  * @filter: filter to be applied
+ * @since: only get entries added/updated after this generation, 0 for all
  * @scan_list: scan list to which entry is added
  *
- * Return: void
+ * Return: true if an entry which was in the db at @since was updated
+ *         after it and no longer passes the filter; a caller holding the
+ *         results up to @since may still have it
  */
-static void scm_get_results(struct wlan_objmgr_psoc *psoc,
+static bool scm_get_results(struct wlan_objmgr_psoc *psoc,
 	struct scan_dbs *scan_db, struct scan_filter *filter,
-	qdf_list_t *scan_list)
+	uint32_t since, qdf_list_t *scan_list)
 {
 	int i, count;
 	struct scan_cache_node *cur_node;
 	struct scan_cache_node *next_node = NULL;
+	QDF_STATUS status;
+	bool stale = false;
 
 	for (i = 0 ; i < SCAN_HASH_SIZE; i++) {
 		cur_node = scm_get_next_node(scan_db,
@@ -1476,13 +1502,22 @@ static void scm_get_results(struct wlan_objmgr_psoc *psoc,
 		if (!count)
 			continue;
 		while (cur_node) {
-			scm_scan_apply_filter_get_entry(psoc,
-				cur_node->entry, filter, scan_list);
+			if (!since ||
+			    (int32_t)(cur_node->generation - since) > 0) {
+				status = scm_scan_apply_filter_get_entry(psoc,
+					cur_node->entry, filter, scan_list);
+				if (since && status == QDF_STATUS_E_NOENT &&
+				    (int32_t)(cur_node->add_generation -
+					      since) <= 0)
+					stale = true;
+			}
 			next_node = scm_get_next_node(scan_db,
 				&scan_db->scan_hash_tbl[i], cur_node);
 			cur_node = next_node;
 		}
 	}
+
+	return stale;
 }
 
 QDF_STATUS scm_purge_scan_results(qdf_list_t *scan_list)
@@ -1551,7 +1586,66 @@ qdf_list_t *scm_get_scan_result(struct wlan_objmgr_pdev *pdev,
 	qdf_list_create(tmp_list,
 			MAX_SCAN_CACHE_SIZE);
 	scm_age_out_entries(psoc, scan_db);
-	scm_get_results(psoc, scan_db, filter, tmp_list);
+	scm_get_results(psoc, scan_db, filter, 0, tmp_list);
+
+	return tmp_list;
+}
+
+qdf_list_t *scm_get_scan_result_delta(struct wlan_objmgr_pdev *pdev,
+				      struct scan_filter *filter,
+				      uint32_t *generation, bool *full)
+{
+	struct wlan_objmgr_psoc *psoc;
+	struct scan_dbs *scan_db;
+	qdf_list_t *tmp_list;
+	uint32_t since = *generation;
+
+	if (!pdev) {
+		scm_err("pdev is NULL");
+		return NULL;
+	}
+
+	psoc = wlan_pdev_get_psoc(pdev);
+	if (!psoc) {
+		scm_err("psoc is NULL");
+		return NULL;
+	}
+
+	scan_db = wlan_pdev_get_scan_db(psoc, pdev);
+	if (!scan_db) {
+		scm_err("scan_db is NULL");
+		return NULL;
+	}
+
+	tmp_list = qdf_mem_malloc_atomic(sizeof(*tmp_list));
+	if (!tmp_list) {
+		scm_err("failed tp allocate scan_result");
+		return NULL;
+	}
+	qdf_list_create(tmp_list,
+			MAX_SCAN_CACHE_SIZE);
+	scm_age_out_entries(psoc, scan_db);
+
+	/*
+	 * Removed entries leave no trace in the db, so a delta can only be
+	 * given if nothing was removed or aged out since @since.
+	 */
+	qdf_spin_lock_bh(&scan_db->scan_db_lock);
+	*generation = scan_db->generation;
+	if (since && (int32_t)(scan_db->del_generation - since) > 0)
+		since = 0;
+	qdf_spin_unlock_bh(&scan_db->scan_db_lock);
+
+	*full = !since;
+	if (scm_get_results(psoc, scan_db, filter, since, tmp_list)) {
+		/*
+		 * An entry the caller may hold was updated and filtered out,
+		 * which cannot be told as a delta, give the full result.
+		 */
+		scm_purge_scan_results(tmp_list);
+		*full = true;
+		return scm_get_scan_result(pdev, filter);
+	}
 
 	return tmp_list;
 }
@@ -2064,6 +2158,7 @@ QDF_STATUS scm_update_scan_mlme_info(struct wlan_objmgr_pdev *pdev,
 			/* Acquire db lock to prevent simultaneous update */
 			qdf_spin_lock_bh(&scan_db->scan_db_lock);
 			scm_update_mlme_info(entry, cur_node->entry);
+			cur_node->generation = ++scan_db->generation;
 			qdf_spin_unlock_bh(&scan_db->scan_db_lock);
 			scm_scan_entry_put_ref(scan_db,
 					cur_node, true);
@@ -2110,6 +2205,7 @@ QDF_STATUS scm_scan_update_mlme_by_bssinfo(struct wlan_objmgr_pdev *pdev,
 			qdf_spin_lock_bh(&scan_db->scan_db_lock);
 			qdf_mem_copy(&entry->mlme_info, mlme,
 					sizeof(struct mlme_info));
+			cur_node->generation = ++scan_db->generation;
 			scm_debug("BSSID: "QDF_MAC_ADDR_FMT" set assoc_state to %d with age %lu ms",
 				  QDF_MAC_ADDR_REF(entry->bssid.bytes),
 				  mlme->assoc_state,
@@ -30,23 +30,50 @@
 #include <wlan_objmgr_vdev_obj.h>
 #include <wlan_scan_public_structs.h>
 
-#define SCAN_HASH_SIZE 64
-#define SCAN_GET_HASH(addr) \
-	(((const uint8_t *)(addr))[QDF_MAC_ADDR_SIZE - 1] % SCAN_HASH_SIZE)
+#define SCAN_HASH_BITS 8
+#define SCAN_HASH_SIZE (1 << SCAN_HASH_BITS)
+#define SCAN_GET_HASH(addr) scm_get_hash((const uint8_t *)(addr))
 
 #define ADJACENT_CHANNEL_RSSI_THRESHOLD -80
 
 /**
  * struct scan_dbs - scan cache data base definition
  * @num_entries: number of scan entries
+ * @generation: incremented on every add, update and removal of an entry
+ * @del_generation: value of @generation at the last entry removal
+ * @scan_db_lock: lock protecting the scan db
  * @scan_hash_tbl: link list of bssid hashed scan cache entries for a pdev
  */
 struct scan_dbs {
 	uint32_t num_entries;
+	uint32_t generation;
+	uint32_t del_generation;
 	qdf_spinlock_t scan_db_lock;
 	qdf_list_t scan_hash_tbl[SCAN_HASH_SIZE];
 };
 
+/**
+ * scm_get_hash() - get the scan db hash bucket for a BSSID
+ * @addr: BSSID
+ *
+ * Hash on the full BSSID instead of the last byte alone. MBSSID, MLO
+ * partner links and co-located APs from the same vendor commonly share
+ * the OUI and differ only in a few bits, so hashing a single byte piles
+ * them into a handful of buckets. Fold both halves of the address and
+ * use a multiplicative hash to spread them over SCAN_HASH_SIZE buckets.
+ *
+ * Return: hash bucket index
+ */
+static inline uint8_t scm_get_hash(const uint8_t *addr)
+{
+	uint32_t key;
+
+	key = ((uint32_t)addr[0] << 16 | (uint32_t)addr[1] << 8 | addr[2]) ^
+	      ((uint32_t)addr[3] << 16 | (uint32_t)addr[4] << 8 | addr[5]);
+
+	return (key * 0x9E3779B1) >> (32 - SCAN_HASH_BITS);
+}
+
 /**
  * struct scan_bcn_probe_event - beacon/probe info
  * @frm_type: frame type
@@ -105,6 +132,29 @@ void scm_age_out_entries(struct wlan_objmgr_psoc *psoc,
 qdf_list_t *scm_get_scan_result(struct wlan_objmgr_pdev *pdev,
 	struct scan_filter *filter);
 
+/**
+ * scm_get_scan_result_delta() - fetches scan results changed since a
+ * generation
+ * @pdev: pdev info
+ * @filter: Filters
+ * @generation: in: generation returned by the previous call, 0 for all
+ *              entries; out: current scan db generation
+ * @full: set to true if the returned list is the complete result, i.e.
+ *        entries were removed or aged out since @generation, or an entry
+ *        was updated and no longer passes @filter, and the caller must
+ *        replace its cached results instead of merging them
+ *
+ * This function fetches only the entries added or updated after
+ * @generation, unless entries were removed in between. The caller must
+ * pass the same @filter on every call. The returned list must be freed
+ * with scm_purge_scan_results().
+ *
+ * Return: scan list
+ */
+qdf_list_t *scm_get_scan_result_delta(struct wlan_objmgr_pdev *pdev,
+				      struct scan_filter *filter,
+				      uint32_t *generation, bool *full);
+
 /**
  * scm_purge_scan_results() - purge the scan list
  * @scan_result: scan list to be purged
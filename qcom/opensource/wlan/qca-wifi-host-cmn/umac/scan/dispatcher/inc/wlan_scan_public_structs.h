@@ -332,12 +332,17 @@ struct bss_info {
  * @node: node pointers
  * @ref_cnt: ref count if in use
  * @cookie: cookie to check if entry is logically active
+ * @generation: scan db generation at which the entry was added/updated
+ * @add_generation: scan db generation at which the BSS was first added,
+ *                  kept when the entry is replaced by an update
  * @entry: scan entry pointer
  */
 struct scan_cache_node {
 	qdf_list_node_t node;
 	qdf_atomic_t ref_cnt;
 	uint32_t cookie;
+	uint32_t generation;
+	uint32_t add_generation;
 	struct scan_cache_entry *entry;
 };
 
@@ -394,6 +394,27 @@ ucfg_scan_cancel_sync(struct scan_cancel_request *req);
 qdf_list_t *ucfg_scan_get_result(struct wlan_objmgr_pdev *pdev,
 	struct scan_filter *filter);
 
+/**
+ * ucfg_scan_get_result_delta() - The Public API to get scan results changed
+ * since a previous fetch
+ * @pdev: pdev info
+ * @filter: Filters
+ * @generation: in: generation returned by the previous call, 0 for all
+ *              entries; out: current scan db generation
+ * @full: set to true if the returned list is the complete result and
+ *        replaces, rather than updates, the results fetched before
+ *
+ * Lets pollers fetch only the entries added or updated since their last
+ * fetch instead of copying the whole scan cache on every call. The same
+ * @filter must be passed on every call. The list must be freed with
+ * ucfg_scan_purge_results().
+ *
+ * Return: scan list pointer
+ */
+qdf_list_t *ucfg_scan_get_result_delta(struct wlan_objmgr_pdev *pdev,
+				       struct scan_filter *filter,
+				       uint32_t *generation, bool *full);
+
 /**
  * ucfg_scan_purge_results() - purge the scan list
  * @scan_list: scan list to be purged
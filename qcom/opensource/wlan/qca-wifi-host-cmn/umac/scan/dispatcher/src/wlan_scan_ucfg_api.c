@@ -54,6 +54,13 @@ qdf_list_t *ucfg_scan_get_result(struct wlan_objmgr_pdev *pdev,
 	return scm_get_scan_result(pdev, filter);
 }
 
+qdf_list_t *ucfg_scan_get_result_delta(struct wlan_objmgr_pdev *pdev,
+				       struct scan_filter *filter,
+				       uint32_t *generation, bool *full)
+{
+	return scm_get_scan_result_delta(pdev, filter, generation, full);
+}
+
 QDF_STATUS ucfg_scan_db_iterate(struct wlan_objmgr_pdev *pdev,
 	scan_iterator_func func, void *arg)
 {
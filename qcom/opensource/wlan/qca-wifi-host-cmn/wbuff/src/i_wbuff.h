@@ -25,6 +25,9 @@
 #define _I_WBUFF_H
 
 #include <qdf_nbuf.h>
+#include <qdf_atomic.h>
+#include <qdf_defer.h>
+#include <qdf_lock.h>
 #include <wbuff.h>
 
 #define WBUFF_MODULE_ID_SHIFT 4
@@ -33,6 +36,15 @@
 #define WBUFF_POOL_ID_SHIFT 1
 #define WBUFF_POOL_ID_BITMASK 0xE
 
+/* Number of buffers held in each per-cpu front cache of a pool */
+#define WBUFF_CPU_CACHE_SIZE 8
+
+/* Shared pool requests observed before the pool target is re-evaluated */
+#define WBUFF_RESIZE_WINDOW 256
+
+/* Adaptive pools may grow up to this multiple of the registered size */
+#define WBUFF_POOL_MAX_SCALE 4
+
 /**
  * struct wbuff_handle - wbuff handle to the registered module
  * @id: the identifier for the registered module.
@@ -41,23 +53,60 @@ struct wbuff_handle {
 	uint8_t id;
 };
 
+/**
+ * struct wbuff_cpu_cache - per-cpu front cache of a wbuff pool
+ * @lock: Lock protecting this cache
+ * @count: Number of buffers currently in @buf
+ * @buf: Cached buffers, used as a stack
+ */
+struct wbuff_cpu_cache {
+	qdf_spinlock_t lock;
+	uint16_t count;
+	qdf_nbuf_t buf[WBUFF_CPU_CACHE_SIZE];
+};
+
 /**
  * struct wbuff_pool - structure representing wbuff pool
  * @initialized: To identify whether pool is initialized
+ * @pinned: Pool size is pinned through debugfs and not adapted
  * @pool: nbuf pool
  * @buffer_size: size of the buffer in this @pool
  * @pool_id: pool identifier
+ * @free: Number of buffers in @pool
+ * @total: Number of buffers owned by this pool, free or in use
+ * @target: Number of buffers the pool is being resized to
+ * @min_size: Lower bound for @target, the registered pool size
+ * @max_size: Upper bound for @target
+ * @low_water: Lowest @free seen in the current resize window
+ * @window: Shared pool requests seen in the current resize window
+ * @caches: Per-cpu front caches, NULL if not available
  * @alloc_success: Successful allocations for this pool
- * @alloc_fail: Failed allocations for this pool
+ * @alloc_fail: Failed allocations for this pool, the caller falls back to
+ * a regular nbuf allocation for each of these
+ * @cache_hit: Allocations served from a per-cpu cache
+ * @grow: Number of times the pool target was raised
+ * @shrink: Number of times the pool target was lowered
  * @mem_alloc: Memory allocated for this pool
  */
 struct wbuff_pool {
 	bool initialized;
+	bool pinned;
 	qdf_nbuf_t pool;
 	uint16_t buffer_size;
 	uint8_t pool_id;
+	uint16_t free;
+	uint16_t total;
+	uint16_t target;
+	uint16_t min_size;
+	uint16_t max_size;
+	uint16_t low_water;
+	uint16_t window;
+	struct wbuff_cpu_cache *caches;
 	uint64_t alloc_success;
 	uint64_t alloc_fail;
+	uint64_t cache_hit;
+	uint64_t grow;
+	uint64_t shrink;
 	uint64_t mem_alloc;
 };
 
@@ -67,6 +116,7 @@ struct wbuff_pool {
  * @pending_returns: Number of buffers pending to be returned to
  * wbuff by the module
  * @lock: Lock for accessing per module buffer pools
+ * @resize_work: Work bringing the module pools to their target size
  * @handle: wbuff handle for the registered module
  * @reserve: nbuf headroom to start with
  * @align: alignment for the nbuf
@@ -74,8 +124,9 @@ struct wbuff_pool {
  */
 struct wbuff_module {
 	bool registered;
-	uint16_t pending_returns;
+	qdf_atomic_t pending_returns;
 	qdf_spinlock_t lock;
+	qdf_work_t resize_work;
 	struct wbuff_handle handle;
 	int reserve;
 	int align;
@@ -86,14 +137,18 @@ struct wbuff_module {
  * struct wbuff_holder - allocation holder for wbuff
  * @initialized: to identified whether module is initialized
  * @pf_cache: Reference to page frag cache, used for nbuf allocations
+ * @pf_cache_lock: Lock serializing allocations from @pf_cache
  * @wbuff_debugfs_dir: wbuff debugfs root directory
  * @wbuff_stats_dentry: wbuff debugfs stats file
+ * @wbuff_pin_dentry: wbuff debugfs file to pin pool sizes
  */
 struct wbuff_holder {
 	bool initialized;
 	struct wbuff_module mod[WBUFF_MAX_MODULES];
 	qdf_frag_cache_t pf_cache;
+	qdf_mutex_t pf_cache_lock;
 	struct dentry *wbuff_debugfs_dir;
 	struct dentry *wbuff_stats_dentry;
+	struct dentry *wbuff_pin_dentry;
 };
 #endif /* _WBUFF_H */
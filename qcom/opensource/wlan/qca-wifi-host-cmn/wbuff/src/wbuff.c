@@ -25,6 +25,7 @@
 #include <wbuff.h>
 #include <linux/debugfs.h>
 #include <linux/seq_file.h>
+#include <linux/uaccess.h>
 #include <qdf_debugfs.h>
 #include "i_wbuff.h"
 
@@ -99,11 +100,11 @@ static qdf_nbuf_t wbuff_prepare_nbuf(uint8_t module_id, uint8_t pool_id,
 {
 	qdf_nbuf_t buf;
 	unsigned long dev_scratch = 0;
-	struct wbuff_module *mod = &wbuff.mod[module_id];
-	struct wbuff_pool *wbuff_pool = &mod->wbuff_pool[pool_id];
 
+	qdf_mutex_acquire(&wbuff.pf_cache_lock);
 	buf = qdf_nbuf_page_frag_alloc(NULL, len, reserve, align,
 				       &wbuff.pf_cache);
+	qdf_mutex_release(&wbuff.pf_cache_lock);
 	if (!buf)
 		return NULL;
 	dev_scratch = module_id;
@@ -111,11 +112,402 @@ static qdf_nbuf_t wbuff_prepare_nbuf(uint8_t module_id, uint8_t pool_id,
 	dev_scratch |= ((pool_id << WBUFF_POOL_ID_SHIFT) | 1);
 	qdf_nbuf_set_dev_scratch(buf, dev_scratch);
 
-	wbuff_pool->mem_alloc += qdf_nbuf_get_allocsize(buf);
+	return buf;
+}
+
+/**
+ * wbuff_pool_pop() - take a buffer from the shared list of a pool
+ * @wbuff_pool: wbuff pool, with the module lock held
+ *
+ * Return: nbuf if available
+ *         NULL if the pool is empty
+ */
+static qdf_nbuf_t wbuff_pool_pop(struct wbuff_pool *wbuff_pool)
+{
+	qdf_nbuf_t buf = wbuff_pool->pool;
+
+	if (!buf)
+		return NULL;
+
+	wbuff_pool->pool = qdf_nbuf_next(buf);
+	wbuff_pool->free--;
+	if (wbuff_pool->free < wbuff_pool->low_water)
+		wbuff_pool->low_water = wbuff_pool->free;
 
 	return buf;
 }
 
+/**
+ * wbuff_pool_push() - return a buffer to the shared list of a pool
+ * @wbuff_pool: wbuff pool, with the module lock held
+ * @buf: buffer to be returned
+ *
+ * Return: None
+ */
+static void wbuff_pool_push(struct wbuff_pool *wbuff_pool, qdf_nbuf_t buf)
+{
+	qdf_nbuf_set_next(buf, wbuff_pool->pool);
+	wbuff_pool->pool = buf;
+	wbuff_pool->free++;
+}
+
+/**
+ * wbuff_pool_grow_step() - number of buffers a pool target moves by
+ * @wbuff_pool: wbuff pool
+ *
+ * Return: resize step for @wbuff_pool
+ */
+static inline uint16_t wbuff_pool_grow_step(struct wbuff_pool *wbuff_pool)
+{
+	return QDF_MAX(wbuff_pool->min_size / 4, 1);
+}
+
+/**
+ * wbuff_pool_account() - account a shared pool request and adapt the target
+ * @wbuff_pool: wbuff pool, with the module lock held
+ * @fail: request could not be served and the caller falls back
+ *
+ * The target is raised by one step whenever a request misses and the
+ * previous resize has completed, so a burst grows the pool quickly. Once
+ * per WBUFF_RESIZE_WINDOW requests without a miss, the target is lowered
+ * by half of the buffers that stayed idle for the whole window, but never
+ * below the registered size.
+ *
+ * Return: true if the pool needs to be resized
+ */
+static bool wbuff_pool_account(struct wbuff_pool *wbuff_pool, bool fail)
+{
+	uint16_t step = wbuff_pool_grow_step(wbuff_pool);
+	uint16_t idle;
+
+	if (wbuff_pool->pinned)
+		return false;
+
+	if (fail) {
+		if (wbuff_pool->total >= wbuff_pool->target &&
+		    wbuff_pool->target < wbuff_pool->max_size) {
+			wbuff_pool->target = QDF_MIN(wbuff_pool->max_size,
+						     wbuff_pool->target + step);
+			wbuff_pool->grow++;
+		}
+		wbuff_pool->window = 0;
+		wbuff_pool->low_water = wbuff_pool->free;
+		goto out;
+	}
+
+	if (++wbuff_pool->window < WBUFF_RESIZE_WINDOW)
+		goto out;
+
+	idle = wbuff_pool->low_water / 2;
+	if (idle >= step && wbuff_pool->target > wbuff_pool->min_size) {
+		wbuff_pool->target = QDF_MAX(wbuff_pool->min_size,
+					     wbuff_pool->target - idle);
+		wbuff_pool->shrink++;
+	}
+	wbuff_pool->window = 0;
+	wbuff_pool->low_water = wbuff_pool->free;
+
+out:
+	return wbuff_pool->total != wbuff_pool->target;
+}
+
+/**
+ * wbuff_cache_get() - take a buffer from the per-cpu cache of a pool
+ * @mod: wbuff module reference
+ * @wbuff_pool: wbuff pool
+ * @resize: set if the pool needs to be resized
+ *
+ * An empty cache is refilled from the shared pool with up to half of its
+ * capacity, leaving room for buffers returned on this cpu. Small pools
+ * only hand out one buffer at a time so other cpus are not starved.
+ *
+ * Return: nbuf if available
+ *         NULL if the pool is empty
+ */
+static qdf_nbuf_t wbuff_cache_get(struct wbuff_module *mod,
+				  struct wbuff_pool *wbuff_pool, bool *resize)
+{
+	struct wbuff_cpu_cache *cache;
+	qdf_nbuf_t buf = NULL;
+	uint16_t fill;
+
+	cache = &wbuff_pool->caches[qdf_get_cpu()];
+
+	qdf_spin_lock_bh(&cache->lock);
+	if (cache->count) {
+		wbuff_pool->cache_hit++;
+	} else {
+		qdf_spin_lock_bh(&mod->lock);
+		fill = wbuff_pool->free > WBUFF_CPU_CACHE_SIZE ?
+			WBUFF_CPU_CACHE_SIZE / 2 : 1;
+		while (cache->count < fill) {
+			buf = wbuff_pool_pop(wbuff_pool);
+			if (!buf)
+				break;
+			cache->buf[cache->count++] = buf;
+		}
+		*resize = wbuff_pool_account(wbuff_pool, !cache->count);
+		qdf_spin_unlock_bh(&mod->lock);
+	}
+
+	buf = cache->count ? cache->buf[--cache->count] : NULL;
+	qdf_spin_unlock_bh(&cache->lock);
+
+	return buf;
+}
+
+/**
+ * wbuff_cache_put() - return a buffer to the per-cpu cache of a pool
+ * @mod: wbuff module reference
+ * @wbuff_pool: wbuff pool
+ * @buf: buffer to be returned
+ *
+ * A full cache spills half of its buffers back to the shared pool.
+ *
+ * Return: true if @buf was consumed
+ *         false if the module is no longer registered
+ */
+static bool wbuff_cache_put(struct wbuff_module *mod,
+			    struct wbuff_pool *wbuff_pool, qdf_nbuf_t buf)
+{
+	struct wbuff_cpu_cache *cache;
+
+	cache = &wbuff_pool->caches[qdf_get_cpu()];
+
+	qdf_spin_lock_bh(&cache->lock);
+	if (!mod->registered) {
+		qdf_spin_unlock_bh(&cache->lock);
+		return false;
+	}
+
+	if (cache->count == WBUFF_CPU_CACHE_SIZE) {
+		qdf_spin_lock_bh(&mod->lock);
+		/*
+		 * The module may have deregistered since the check above and
+		 * freed its pool; leave the cache to wbuff_caches_drain().
+		 */
+		if (!mod->registered) {
+			qdf_spin_unlock_bh(&mod->lock);
+			qdf_spin_unlock_bh(&cache->lock);
+			return false;
+		}
+		while (cache->count > WBUFF_CPU_CACHE_SIZE / 2)
+			wbuff_pool_push(wbuff_pool,
+					cache->buf[--cache->count]);
+		qdf_spin_unlock_bh(&mod->lock);
+	}
+	cache->buf[cache->count++] = buf;
+	qdf_atomic_dec(&mod->pending_returns);
+	qdf_spin_unlock_bh(&cache->lock);
+
+	return true;
+}
+
+/**
+ * wbuff_caches_alloc() - allocate the per-cpu caches of a pool
+ * @wbuff_pool: wbuff pool
+ *
+ * Caches are kept across module re-registration and only freed on
+ * wbuff_module_deinit(), since wbuff_buff_put() may still be using them
+ * while a module deregisters. A pool without caches works directly on
+ * the shared list.
+ *
+ * Return: None
+ */
+static void wbuff_caches_alloc(struct wbuff_pool *wbuff_pool)
+{
+	int cpu;
+
+	if (wbuff_pool->caches)
+		return;
+
+	wbuff_pool->caches = qdf_mem_malloc(QDF_MAX_AVAILABLE_CPU *
+					    sizeof(*wbuff_pool->caches));
+	if (!wbuff_pool->caches)
+		return;
+
+	for (cpu = 0; cpu < QDF_MAX_AVAILABLE_CPU; cpu++)
+		qdf_spinlock_create(&wbuff_pool->caches[cpu].lock);
+}
+
+/**
+ * wbuff_caches_drain() - free the buffers held in the per-cpu caches
+ * @wbuff_pool: wbuff pool
+ *
+ * Return: None
+ */
+static void wbuff_caches_drain(struct wbuff_pool *wbuff_pool)
+{
+	struct wbuff_cpu_cache *cache;
+	int cpu;
+
+	if (!wbuff_pool->caches)
+		return;
+
+	for (cpu = 0; cpu < QDF_MAX_AVAILABLE_CPU; cpu++) {
+		cache = &wbuff_pool->caches[cpu];
+		qdf_spin_lock_bh(&cache->lock);
+		while (cache->count)
+			qdf_nbuf_free(cache->buf[--cache->count]);
+		qdf_spin_unlock_bh(&cache->lock);
+	}
+}
+
+/**
+ * wbuff_caches_free() - free the per-cpu caches of a pool
+ * @wbuff_pool: wbuff pool
+ *
+ * Return: None
+ */
+static void wbuff_caches_free(struct wbuff_pool *wbuff_pool)
+{
+	int cpu;
+
+	if (!wbuff_pool->caches)
+		return;
+
+	wbuff_caches_drain(wbuff_pool);
+	for (cpu = 0; cpu < QDF_MAX_AVAILABLE_CPU; cpu++)
+		qdf_spinlock_destroy(&wbuff_pool->caches[cpu].lock);
+
+	qdf_mem_free(wbuff_pool->caches);
+	wbuff_pool->caches = NULL;
+}
+
+/**
+ * wbuff_pool_resize() - bring a pool to its target size
+ * @mod: wbuff module reference
+ * @wbuff_pool: wbuff pool
+ *
+ * Buffers are allocated outside the module lock; buffers above the target
+ * are only reclaimed from the shared list, in-use and cached buffers are
+ * left alone and trimmed on a later resize.
+ *
+ * Return: None
+ */
+static void wbuff_pool_resize(struct wbuff_module *mod,
+			      struct wbuff_pool *wbuff_pool)
+{
+	qdf_nbuf_t head = NULL, buf;
+	uint16_t count = 0;
+	int delta;
+
+	qdf_spin_lock_bh(&mod->lock);
+	delta = (int)wbuff_pool->target - wbuff_pool->total;
+	while (delta < 0 && mod->registered) {
+		buf = wbuff_pool_pop(wbuff_pool);
+		if (!buf)
+			break;
+		qdf_nbuf_set_next(buf, head);
+		head = buf;
+		wbuff_pool->total--;
+		wbuff_pool->mem_alloc -= qdf_nbuf_get_allocsize(buf);
+		delta++;
+	}
+	qdf_spin_unlock_bh(&mod->lock);
+
+	while (head) {
+		buf = head;
+		head = qdf_nbuf_next(buf);
+		qdf_nbuf_free(buf);
+	}
+
+	for (; count < delta; count++) {
+		buf = wbuff_prepare_nbuf(mod->handle.id, wbuff_pool->pool_id,
+					 wbuff_pool->buffer_size, mod->reserve,
+					 mod->align);
+		if (!buf)
+			break;
+		qdf_nbuf_set_next(buf, head);
+		head = buf;
+	}
+
+	if (!head)
+		return;
+
+	qdf_spin_lock_bh(&mod->lock);
+	if (mod->registered) {
+		while (head) {
+			buf = head;
+			head = qdf_nbuf_next(buf);
+			wbuff_pool->mem_alloc += qdf_nbuf_get_allocsize(buf);
+			wbuff_pool_push(wbuff_pool, buf);
+		}
+		wbuff_pool->total += count;
+	}
+	qdf_spin_unlock_bh(&mod->lock);
+
+	while (head) {
+		buf = head;
+		head = qdf_nbuf_next(buf);
+		qdf_nbuf_free(buf);
+	}
+}
+
+/**
+ * wbuff_resize_work() - resize the pools of a module to their target
+ * @arg: wbuff module reference
+ *
+ * Return: None
+ */
+static void wbuff_resize_work(void *arg)
+{
+	struct wbuff_module *mod = arg;
+	int i;
+
+	for (i = 0; i < WBUFF_MAX_POOLS; i++) {
+		if (!mod->registered)
+			return;
+
+		if (mod->wbuff_pool[i].initialized)
+			wbuff_pool_resize(mod, &mod->wbuff_pool[i]);
+	}
+}
+
+/**
+ * wbuff_pool_pin() - pin the size of a pool
+ * @module_id: module identifier
+ * @pool_id: pool identifier
+ * @size: number of buffers to pin the pool to, 0 to let it adapt again
+ *
+ * Return: QDF_STATUS_SUCCESS - pool size updated
+ *         QDF_STATUS_E_INVAL - no such registered pool
+ */
+static QDF_STATUS wbuff_pool_pin(uint32_t module_id, uint32_t pool_id,
+				 uint32_t size)
+{
+	struct wbuff_module *mod;
+	struct wbuff_pool *wbuff_pool;
+
+	if (module_id >= WBUFF_MAX_MODULES || pool_id >= WBUFF_MAX_POOLS ||
+	    size > 0xFFFF)
+		return QDF_STATUS_E_INVAL;
+
+	mod = &wbuff.mod[module_id];
+	wbuff_pool = &mod->wbuff_pool[pool_id];
+
+	qdf_spin_lock_bh(&mod->lock);
+	if (!mod->registered || !wbuff_pool->initialized) {
+		qdf_spin_unlock_bh(&mod->lock);
+		return QDF_STATUS_E_INVAL;
+	}
+
+	wbuff_pool->pinned = !!size;
+	if (size)
+		wbuff_pool->target = size;
+	else
+		wbuff_pool->target = QDF_MAX(wbuff_pool->min_size,
+					     QDF_MIN(wbuff_pool->max_size,
+						     wbuff_pool->total));
+	wbuff_pool->window = 0;
+	wbuff_pool->low_water = wbuff_pool->free;
+	qdf_spin_unlock_bh(&mod->lock);
+
+	qdf_sched_work(0, &mod->resize_work);
+
+	return QDF_STATUS_SUCCESS;
+}
+
 /**
  * wbuff_is_valid_handle() - validate wbuff handle
  * @handle: wbuff handle passed by module
@@ -178,10 +570,14 @@ static int wbuff_stats_debugfs_show(qdf_debugfs_file_t file, void *data)
 		wbuff_debugfs_print(file, "Module (%d) : %s\n", i,
 				    wbuff_get_mod_name(i));
 
-		wbuff_debugfs_print(file, "%s %25s %20s %20s\n", "Pool ID",
+		wbuff_debugfs_print(file, "%s %25s %20s %20s %20s %8s %8s %8s %8s %8s %6s\n",
+				    "Pool ID",
 				    "Mem Allocated (In Bytes)",
 				    "Wbuff Success Count",
-				    "Wbuff Fail Count");
+				    "Wbuff Fail Count",
+				    "Cache Hit Count",
+				    "Free", "Total", "Target", "Grow",
+				    "Shrink", "Pinned");
 
 		for (j = 0; j < WBUFF_MAX_POOLS; j++) {
 			wbuff_pool = &mod->wbuff_pool[j];
@@ -189,10 +585,17 @@ static int wbuff_stats_debugfs_show(qdf_debugfs_file_t file, void *data)
 			if (!wbuff_pool->initialized)
 				continue;
 
-			wbuff_debugfs_print(file, "%d %30llu %20llu %20llu\n",
+			wbuff_debugfs_print(file, "%d %30llu %20llu %20llu %20llu %8u %8u %8u %8llu %8llu %6u\n",
 					    j, wbuff_pool->mem_alloc,
 					    wbuff_pool->alloc_success,
-					    wbuff_pool->alloc_fail);
+					    wbuff_pool->alloc_fail,
+					    wbuff_pool->cache_hit,
+					    wbuff_pool->free,
+					    wbuff_pool->total,
+					    wbuff_pool->target,
+					    wbuff_pool->grow,
+					    wbuff_pool->shrink,
+					    wbuff_pool->pinned);
 		}
 		wbuff_debugfs_print(file, "\n");
 	}
@@ -214,6 +617,47 @@ static const struct file_operations wbuff_stats_fops = {
 	.llseek         = seq_lseek,
 };
 
+/**
+ * wbuff_pin_debugfs_write() - pin a pool size from debugfs
+ * @file: debugfs file
+ * @ubuf: user buffer holding "<module id> <pool id> <size>"
+ * @count: size of @ubuf
+ * @ppos: file position
+ *
+ * A size of 0 unpins the pool and lets it adapt to demand again.
+ *
+ * Return: @count on success, negative errno on failure
+ */
+static ssize_t wbuff_pin_debugfs_write(struct file *file,
+				       const char __user *ubuf,
+				       size_t count, loff_t *ppos)
+{
+	char buf[32];
+	uint32_t module_id, pool_id, size;
+
+	if (count >= sizeof(buf))
+		return -EINVAL;
+
+	if (copy_from_user(buf, ubuf, count))
+		return -EFAULT;
+	buf[count] = '\0';
+
+	if (sscanf(buf, "%u %u %u", &module_id, &pool_id, &size) != 3)
+		return -EINVAL;
+
+	if (QDF_IS_STATUS_ERROR(wbuff_pool_pin(module_id, pool_id, size)))
+		return -EINVAL;
+
+	return count;
+}
+
+static const struct file_operations wbuff_pin_fops = {
+	.owner          = THIS_MODULE,
+	.open           = simple_open,
+	.write          = wbuff_pin_debugfs_write,
+	.llseek         = noop_llseek,
+};
+
 static QDF_STATUS wbuff_debugfs_init(void)
 {
 	wbuff.wbuff_debugfs_dir =
@@ -229,6 +673,13 @@ static QDF_STATUS wbuff_debugfs_init(void)
 	if (!wbuff.wbuff_stats_dentry)
 		return QDF_STATUS_E_FAILURE;
 
+	wbuff.wbuff_pin_dentry =
+		qdf_debugfs_create_entry("wbuff_pin", QDF_FILE_USR_WRITE,
+					 wbuff.wbuff_debugfs_dir, NULL,
+					 &wbuff_pin_fops);
+	if (!wbuff.wbuff_pin_dentry)
+		return QDF_STATUS_E_FAILURE;
+
 	return QDF_STATUS_SUCCESS;
 }
 
@@ -251,11 +702,15 @@ QDF_STATUS wbuff_module_init(void)
 		return QDF_STATUS_E_NOSUPPORT;
 	}
 
+	qdf_mutex_create(&wbuff.pf_cache_lock);
+
 	for (module_id = 0; module_id < WBUFF_MAX_MODULES; module_id++) {
 		mod = &wbuff.mod[module_id];
 		qdf_spinlock_create(&mod->lock);
+		qdf_create_work(0, &mod->resize_work, wbuff_resize_work, mod);
 		for (pool_id = 0; pool_id < WBUFF_MAX_POOLS; pool_id++)
 			mod->wbuff_pool[pool_id].pool = NULL;
+		qdf_atomic_init(&mod->pending_returns);
 		mod->registered = false;
 	}
 
@@ -269,7 +724,7 @@ QDF_STATUS wbuff_module_init(void)
 QDF_STATUS wbuff_module_deinit(void)
 {
 	struct wbuff_module *mod = NULL;
-	uint8_t module_id = 0;
+	uint8_t module_id = 0, pool_id = 0;
 
 	if (!wbuff.initialized)
 		return QDF_STATUS_E_INVAL;
@@ -282,9 +737,14 @@ QDF_STATUS wbuff_module_deinit(void)
 		if (mod->registered)
 			wbuff_module_deregister((struct wbuff_mod_handle *)
 						&mod->handle);
+		qdf_destroy_work(0, &mod->resize_work);
+		for (pool_id = 0; pool_id < WBUFF_MAX_POOLS; pool_id++)
+			wbuff_caches_free(&mod->wbuff_pool[pool_id]);
 		qdf_spinlock_destroy(&mod->lock);
 	}
 
+	qdf_mutex_destroy(&wbuff.pf_cache_lock);
+
 	return QDF_STATUS_SUCCESS;
 }
 
@@ -296,6 +756,7 @@ wbuff_module_register(struct wbuff_alloc_request *req, uint8_t num_pools,
 	struct wbuff_pool *wbuff_pool;
 	qdf_nbuf_t buf = NULL;
 	uint32_t len;
+	uint32_t max_size;
 	uint16_t pool_size;
 	uint8_t pool_id;
 	int i;
@@ -318,6 +779,8 @@ wbuff_module_register(struct wbuff_alloc_request *req, uint8_t num_pools,
 		return NULL;
 
 	mod->handle.id = module_id;
+	mod->reserve = reserve;
+	mod->align = align;
 
 	for (i = 0; i < num_pools; i++) {
 		pool_id = req[i].pool_id;
@@ -338,21 +801,31 @@ wbuff_module_register(struct wbuff_alloc_request *req, uint8_t num_pools,
 			if (!buf)
 				continue;
 
+			wbuff_pool->mem_alloc += qdf_nbuf_get_allocsize(buf);
 			if (!wbuff_pool->pool)
 				qdf_nbuf_set_next(buf, NULL);
 			else
 				qdf_nbuf_set_next(buf, wbuff_pool->pool);
 
 			wbuff_pool->pool = buf;
+			wbuff_pool->free++;
 		}
 
+		max_size = (uint32_t)pool_size * WBUFF_POOL_MAX_SCALE;
+		wbuff_pool->total = wbuff_pool->free;
+		wbuff_pool->target = pool_size;
+		wbuff_pool->min_size = pool_size;
+		wbuff_pool->max_size = QDF_MIN(max_size, 0xFFFF);
+		wbuff_pool->low_water = wbuff_pool->free;
+		wbuff_pool->window = 0;
+		wbuff_pool->pinned = false;
+		wbuff_caches_alloc(wbuff_pool);
+
 		wbuff_pool->pool_id = pool_id;
 		wbuff_pool->buffer_size = len;
 		wbuff_pool->initialized = true;
 	}
 
-	mod->reserve = reserve;
-	mod->align = align;
 	mod->registered = true;
 
 
@@ -393,14 +866,25 @@ QDF_STATUS wbuff_module_deregister(struct wbuff_mod_handle *hdl)
 			qdf_nbuf_free(buf);
 		}
 
+		wbuff_pool->pool = NULL;
+		wbuff_pool->free = 0;
+		wbuff_pool->total = 0;
 		wbuff_pool->mem_alloc = 0;
 		wbuff_pool->alloc_success = 0;
 		wbuff_pool->alloc_fail = 0;
+		wbuff_pool->cache_hit = 0;
+		wbuff_pool->grow = 0;
+		wbuff_pool->shrink = 0;
 
 	}
 	mod->registered = false;
 	qdf_spin_unlock_bh(&mod->lock);
 
+	for (pool_id = 0; pool_id < WBUFF_MAX_POOLS; pool_id++)
+		wbuff_caches_drain(&mod->wbuff_pool[pool_id]);
+
+	qdf_flush_work(&mod->resize_work);
+
 	return QDF_STATUS_SUCCESS;
 }
 
@@ -413,6 +897,7 @@ wbuff_buff_get(struct wbuff_mod_handle *hdl, uint8_t pool_id, uint32_t len,
 	struct wbuff_pool *wbuff_pool;
 	uint8_t module_id = 0;
 	qdf_nbuf_t buf = NULL;
+	bool resize = false;
 
 	handle = (struct wbuff_handle *)hdl;
 
@@ -437,15 +922,20 @@ wbuff_buff_get(struct wbuff_mod_handle *hdl, uint8_t pool_id, uint32_t len,
 	if (!wbuff_pool->initialized)
 		return NULL;
 
-	qdf_spin_lock_bh(&mod->lock);
-	if (wbuff_pool->pool) {
-		buf = wbuff_pool->pool;
-		wbuff_pool->pool = qdf_nbuf_next(buf);
-		mod->pending_returns++;
+	if (wbuff_pool->caches) {
+		buf = wbuff_cache_get(mod, wbuff_pool, &resize);
+	} else {
+		qdf_spin_lock_bh(&mod->lock);
+		buf = wbuff_pool_pop(wbuff_pool);
+		resize = wbuff_pool_account(wbuff_pool, !buf);
+		qdf_spin_unlock_bh(&mod->lock);
 	}
-	qdf_spin_unlock_bh(&mod->lock);
+
+	if (resize)
+		qdf_sched_work(0, &mod->resize_work);
 
 	if (buf) {
+		qdf_atomic_inc(&mod->pending_returns);
 		qdf_nbuf_set_next(buf, NULL);
 		qdf_net_buf_debug_update_node(buf, func_name, line_num);
 		wbuff_pool->alloc_success++;
@@ -484,11 +974,16 @@ qdf_nbuf_t wbuff_buff_put(qdf_nbuf_t buf)
 	qdf_nbuf_reset(buffer, wbuff.mod[module_id].reserve,
 		       wbuff.mod[module_id].align);
 
+	if (wbuff_pool->caches) {
+		if (wbuff_cache_put(&wbuff.mod[module_id], wbuff_pool, buffer))
+			buffer = NULL;
+		return buffer;
+	}
+
 	qdf_spin_lock_bh(&wbuff.mod[module_id].lock);
 	if (wbuff.mod[module_id].registered) {
-		qdf_nbuf_set_next(buffer, wbuff_pool->pool);
-		wbuff_pool->pool = buffer;
-		wbuff.mod[module_id].pending_returns--;
+		wbuff_pool_push(wbuff_pool, buffer);
+		qdf_atomic_dec(&wbuff.mod[module_id].pending_returns);
 		buffer = NULL;
 	}
 	qdf_spin_unlock_bh(&wbuff.mod[module_id].lock);
@@ -1920,6 +1920,9 @@ enum wlan_state_ctrl_str_id {
  * @file_name:
  * @dbam_mode:
  * @bridgeaddr: Bridge MAC address
+ * @son_scan_list: scan results kept across SON ACS report polls
+ * @son_scan_gen: scan db generation @son_scan_list is up to date with
+ * @son_scan_lock: protects @son_scan_list and @son_scan_gen
  */
 struct hdd_context {
 	struct wlan_objmgr_psoc *psoc;
@@ -2203,6 +2206,11 @@ struct hdd_context {
 	enum coex_dbam_config_mode dbam_mode;
 #endif
 	uint8_t bridgeaddr[QDF_MAC_ADDR_SIZE];
+#ifdef WLAN_FEATURE_SON
+	qdf_list_t *son_scan_list;
+	uint32_t son_scan_gen;
+	qdf_mutex_t son_scan_lock;
+#endif
 };
 
 /**
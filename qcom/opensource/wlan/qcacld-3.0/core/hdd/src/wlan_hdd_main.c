@@ -4790,6 +4790,7 @@ sched_disable:
 	hdd_destroy_sysfs_files();
 	cds_post_disable();
 unregister_notifiers:
+	hdd_son_deregister_callbacks(hdd_ctx);
 	hdd_unregister_notifiers(hdd_ctx);
 
 deregister_cb:
@@ -15254,6 +15255,7 @@ int hdd_wlan_stop_modules(struct hdd_context *hdd_ctx, bool ftm_mode)
 			QDF_ASSERT(0);
 		}
 
+		hdd_son_deregister_callbacks(hdd_ctx);
 		hdd_unregister_notifiers(hdd_ctx);
 		/* De-register the SME callbacks */
 		hdd_deregister_cb(hdd_ctx);
@@ -2086,23 +2086,110 @@ reg_wifi_band_to_wlan_band_id(enum reg_wifi_band reg_wifi_band)
 	return wlan_band;
 }
 
+/**
+ * hdd_son_scan_cache_replace() - put a scan entry in the kept scan results
+ * @scan_list: kept scan results
+ * @scan_node: scan node to put, replacing the older entry of the same BSS
+ *
+ * Return: void
+ */
+static void hdd_son_scan_cache_replace(qdf_list_t *scan_list,
+				       struct scan_cache_node *scan_node)
+{
+	struct scan_cache_node *cur_node;
+	qdf_list_node_t *cur_lst = NULL, *next_lst = NULL;
+
+	qdf_list_peek_front(scan_list, &cur_lst);
+	while (cur_lst) {
+		qdf_list_peek_next(scan_list, cur_lst, &next_lst);
+		cur_node = qdf_container_of(cur_lst,
+					    struct scan_cache_node, node);
+		if (util_is_scan_entry_match(cur_node->entry,
+					     scan_node->entry)) {
+			qdf_list_remove_node(scan_list, cur_lst);
+			util_scan_free_cache_entry(cur_node->entry);
+			qdf_mem_free(cur_node);
+			break;
+		}
+		cur_lst = next_lst;
+		next_lst = NULL;
+	}
+
+	qdf_list_insert_front(scan_list, &scan_node->node);
+}
+
+/**
+ * hdd_son_update_scan_cache() - bring the kept scan results up to date
+ * @hdd_ctx: hdd context, with son_scan_lock held
+ * @pdev: pointer to object mgr pdev
+ *
+ * ACS reports are polled one channel at a time. Rather than copying the
+ * whole scan cache for every channel, only the entries changed since the
+ * previous poll are fetched and merged into the kept results.
+ *
+ * Return: the kept scan results, NULL if there are none
+ */
+static qdf_list_t *hdd_son_update_scan_cache(struct hdd_context *hdd_ctx,
+					     struct wlan_objmgr_pdev *pdev)
+{
+	struct scan_filter *filter;
+	struct scan_cache_node *cur_node;
+	qdf_list_node_t *cur_lst = NULL, *next_lst = NULL;
+	qdf_list_t *delta;
+	bool full = false;
+
+	if (!hdd_ctx->son_scan_list)
+		hdd_ctx->son_scan_gen = 0;
+
+	/* the same filter has to be passed on every delta fetch */
+	filter = qdf_mem_malloc(sizeof(*filter));
+	if (!filter)
+		return hdd_ctx->son_scan_list;
+
+	delta = ucfg_scan_get_result_delta(pdev, filter,
+					   &hdd_ctx->son_scan_gen, &full);
+	qdf_mem_free(filter);
+	if (!delta)
+		return hdd_ctx->son_scan_list;
+
+	if (full || !hdd_ctx->son_scan_list) {
+		if (hdd_ctx->son_scan_list)
+			ucfg_scan_purge_results(hdd_ctx->son_scan_list);
+		hdd_ctx->son_scan_list = delta;
+		return delta;
+	}
+
+	qdf_list_peek_front(delta, &cur_lst);
+	while (cur_lst) {
+		qdf_list_peek_next(delta, cur_lst, &next_lst);
+		cur_node = qdf_container_of(cur_lst,
+					    struct scan_cache_node, node);
+		qdf_list_remove_node(delta, cur_lst);
+		hdd_son_scan_cache_replace(hdd_ctx->son_scan_list, cur_node);
+		cur_lst = next_lst;
+		next_lst = NULL;
+	}
+	ucfg_scan_purge_results(delta);
+
+	return hdd_ctx->son_scan_list;
+}
+
 /**
  * get_son_acs_report_values() - Gets ACS report for target channel
  *
  * @vdev: pointer to object mgr vdev
  * @acs_r: pointer to acs_dbg
- * @mac_handle: Handle to MAC
+ * @hdd_ctx: hdd context
  * @chan_freq: Channel frequency
  *
  * Return: void
  */
 static void get_son_acs_report_values(struct wlan_objmgr_vdev *vdev,
 				      struct ieee80211_acs_dbg *acs_r,
-				      mac_handle_t mac_handle,
+				      struct hdd_context *hdd_ctx,
 				      uint16_t chan_freq)
 {
 	struct wlan_objmgr_pdev *pdev = wlan_vdev_get_pdev(vdev);
-	struct scan_filter *filter = qdf_mem_malloc(sizeof(*filter));
 	struct scan_cache_node *cur_node;
 	struct scan_cache_entry *se;
 	enum ieee80211_phymode phymode_se;
@@ -2113,25 +2200,29 @@ static void get_son_acs_report_values(struct wlan_objmgr_vdev *vdev,
 	qdf_list_t *scan_list = NULL;
 	uint8_t snr_se, *hecap_phy_ie;
 
-	if (!filter)
-		return;
-	filter->num_of_channels = 1;
-	filter->chan_freq_list[0] = chan_freq;
-	scan_list = ucfg_scan_get_result(pdev, filter);
-	acs_r->chan_nbss = qdf_list_size(scan_list);
-
+	acs_r->chan_nbss = 0;
 	acs_r->chan_maxrssi = 0;
 	acs_r->chan_minrssi = 0;
 	acs_r->chan_nbss_near = 0;
 	acs_r->chan_nbss_mid = 0;
 	acs_r->chan_nbss_far = 0;
 	acs_r->chan_nbss_srp = 0;
-	qdf_list_peek_front(scan_list, &cur_lst);
+
+	qdf_mutex_acquire(&hdd_ctx->son_scan_lock);
+	scan_list = hdd_son_update_scan_cache(hdd_ctx, pdev);
+	if (scan_list)
+		qdf_list_peek_front(scan_list, &cur_lst);
 	while (cur_lst) {
 		qdf_list_peek_next(scan_list, cur_lst, &next_lst);
 		cur_node = qdf_container_of(cur_lst,
 					    struct scan_cache_node, node);
 		se = cur_node->entry;
+		cur_lst = next_lst;
+		next_lst = NULL;
+		if (se->channel.chan_freq != chan_freq)
+			continue;
+
+		acs_r->chan_nbss++;
 		snr_se = util_scan_entry_snr(se);
 		hecap_ie = (struct ieee80211_ie_hecap *)
 			   util_scan_entry_hecap(se);
@@ -2159,21 +2250,17 @@ static void get_son_acs_report_values(struct wlan_objmgr_vdev *vdev,
 		    (!(srp_ie->sr_control &
 		       IEEE80211_SRP_SRCTRL_OBSS_PD_DISALLOWED_MASK) || srps))
 			acs_r->chan_nbss_srp++;
-
-		cur_lst = next_lst;
-		next_lst = NULL;
 	}
-	acs_r->chan_80211_b_duration = sme_get_11b_data_duration(mac_handle,
-								 chan_freq);
+	qdf_mutex_release(&hdd_ctx->son_scan_lock);
+
+	acs_r->chan_80211_b_duration =
+		sme_get_11b_data_duration(hdd_ctx->mac_handle, chan_freq);
 	acs_r->chan_nbss_eff = 100 + (acs_r->chan_nbss_near * 50)
 				   + (acs_r->chan_nbss_mid * 50)
 				   + (acs_r->chan_nbss_far * 25);
 	acs_r->chan_srp_load = acs_r->chan_nbss_srp * 4;
 	acs_r->chan_efficiency = (1000 + acs_r->chan_grade) /
 				  acs_r->chan_nbss_eff;
-	ucfg_scan_purge_results(scan_list);
-
-	qdf_mem_free(filter);
 }
 
 /**
@@ -2267,7 +2354,7 @@ static int hdd_son_get_acs_report(struct wlan_objmgr_vdev *vdev,
 		acs_r->chan_radar_noise =
 		    wlansap_is_channel_in_nol_list(sap_ctx, acs_r->chan_freq,
 						   PHY_SINGLE_CHANNEL_CENTERED);
-		get_son_acs_report_values(vdev, acs_r, hdd_ctx->mac_handle,
+		get_son_acs_report_values(vdev, acs_r, hdd_ctx,
 					  acs_r->chan_freq);
 		acs_r->chan_load = 0;
 		acs_r->noisefloor = -254; /* NF_INVALID */
@@ -2556,6 +2643,10 @@ void hdd_son_register_callbacks(struct hdd_context *hdd_ctx)
 {
 	struct son_callbacks cb_obj = {0};
 
+	qdf_mutex_create(&hdd_ctx->son_scan_lock);
+	hdd_ctx->son_scan_list = NULL;
+	hdd_ctx->son_scan_gen = 0;
+
 	cb_obj.os_if_is_acs_in_progress = hdd_son_is_acs_in_progress;
 	cb_obj.os_if_set_chan_ext_offset = hdd_son_set_chan_ext_offset;
 	cb_obj.os_if_get_chan_ext_offset = hdd_son_get_chan_ext_offset;
@@ -2600,6 +2691,16 @@ void hdd_son_register_callbacks(struct hdd_context *hdd_ctx)
 					  hdd_son_deliver_smps);
 }
 
+void hdd_son_deregister_callbacks(struct hdd_context *hdd_ctx)
+{
+	qdf_mutex_acquire(&hdd_ctx->son_scan_lock);
+	if (hdd_ctx->son_scan_list)
+		ucfg_scan_purge_results(hdd_ctx->son_scan_list);
+	hdd_ctx->son_scan_list = NULL;
+	qdf_mutex_release(&hdd_ctx->son_scan_lock);
+	qdf_mutex_destroy(&hdd_ctx->son_scan_lock);
+}
+
 int hdd_son_deliver_acs_complete_event(struct hdd_adapter *adapter)
 {
 	int ret = -EINVAL;
@@ -45,6 +45,15 @@ enum assoc_disassoc_event {
  */
 void hdd_son_register_callbacks(struct hdd_context *hdd_ctx);
 
+/**
+ * hdd_son_deregister_callbacks() - release what hdd_son_register_callbacks()
+ *  set up
+ * @hdd_ctx: hdd context
+ *
+ * Return: void
+ */
+void hdd_son_deregister_callbacks(struct hdd_context *hdd_ctx);
+
 /**
  * hdd_son_deliver_acs_complete_event() - send acs complete event to son
  * @adapter: adapter object
@@ -128,6 +137,10 @@ static inline void hdd_son_register_callbacks(struct hdd_context *hdd_ctx)
 {
 }
 
+static inline void hdd_son_deregister_callbacks(struct hdd_context *hdd_ctx)
+{
+}
+
 static inline int
 	hdd_son_deliver_acs_complete_event(struct hdd_adapter *adapter)
 {
@@ -24,6 +24,7 @@
  */
 #include "wlan_hdd_main.h"
 #include "qdf_delayed_work_test.h"
+#include "qdf_flex_mem_test.h"
 #include "qdf_hashtable_test.h"
 #include "qdf_periodic_work_test.h"
 #include "qdf_ptr_hash_test.h"
@@ -46,6 +47,7 @@ struct hdd_ut_entry {
 struct hdd_ut_entry hdd_ut_entries[] = {
 	{ .name = "dsc", .callback = dsc_unit_test },
 	{ .name = "qdf_delayed_work", .callback = qdf_delayed_work_unit_test },
+	{ .name = "qdf_flex_mem", .callback = qdf_flex_mem_unit_test },
 	{ .name = "qdf_ht", .callback = qdf_ht_unit_test },
 	{ .name = "qdf_periodic_work",
 	  .callback = qdf_periodic_work_unit_test },